@@ -0,0 +1,347 @@
+// ALT point-to-point shortest paths
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Alt.h"
+#include "PriorityQueue.h"
+
+// A distance of INT_MAX or more (including no path at all). The landmark
+// searches give up on a path once it reaches INT_MAX, so UNREACHED is a
+// lower bound on the true distance, which keeps the bounds below valid
+#define UNREACHED INT_MAX
+
+// One direction of the bidirectional search. dist is UNREACHED outside of
+// a query, which only resets the computers listed in touched
+struct side {
+	int *dist;
+	int *touched;
+	int numTouched;
+	Pq pq;
+};
+
+// from[v * stride + i] is the distance from landmark i to v and
+// to[v * stride + i] the distance from v to landmark i, so the bounds for
+// one computer are read from two short runs of memory
+struct alt {
+	Graph g;
+	int numLandmarks;
+	int stride;
+	int *from;
+	int *to;
+	struct side forward;
+	struct side backward;
+};
+
+static void sweep(Alt alt, int root, bool reverse, int dist[]);
+static int farthest(long long score[], int numVert);
+static int boundTo(Alt alt, int v, int t);
+static int boundFrom(Alt alt, int s, int v);
+static void scan(Alt alt, struct side *near, struct side *far, bool reverse, int src, int dest, int limit, int *best);
+static void sideInit(struct side *s, int numVert);
+static void sideReset(struct side *s);
+
+Alt AltNew(Graph g, int numLandmarks) {
+	int numVert = GraphNumVertices(g);
+	if (numLandmarks > numVert) {
+		numLandmarks = numVert;
+	}
+	assert(numLandmarks >= 0);
+
+	Alt alt = malloc(sizeof(struct alt));
+	if (alt == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	alt->g = g;
+	alt->numLandmarks = 0;
+	alt->stride = numLandmarks;
+	alt->from = malloc((size_t)numVert * numLandmarks * sizeof(int));
+	alt->to = malloc((size_t)numVert * numLandmarks * sizeof(int));
+	sideInit(&alt->forward, numVert);
+	sideInit(&alt->backward, numVert);
+
+	int *dist = malloc(numVert * sizeof(int));
+	long long *score = malloc(numVert * sizeof(long long));
+	if ((numVert > 0 && (dist == NULL || score == NULL))
+	    || (numVert > 0 && numLandmarks > 0 && (alt->from == NULL || alt->to == NULL))) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// farthest selection: the first landmark is the computer farthest from
+	// the one with the most arcs out, and each one after that is the
+	// computer with the longest round trip to the nearest landmark so far.
+	// only computers with a round trip to the first landmark are candidates,
+	// so that landmarks are not wasted on computers cut off from the rest
+	int next = 0;
+	if (numLandmarks > 0) {
+		int start = 0;
+		for (int v = 1; v < numVert; v++) {
+			if (GraphGetOutArcs(g, v).count > GraphGetOutArcs(g, start).count) {
+				start = v;
+			}
+		}
+
+		sweep(alt, start, false, dist);
+		for (int v = 0; v < numVert; v++) {
+			score[v] = dist[v] == UNREACHED ? -1 : dist[v];
+		}
+		next = farthest(score, numVert);
+	}
+
+	for (int i = 0; i < numLandmarks; i++) {
+		sweep(alt, next, false, dist);
+		for (int v = 0; v < numVert; v++) {
+			alt->from[(size_t)v * alt->stride + i] = dist[v];
+		}
+
+		sweep(alt, next, true, dist);
+		for (int v = 0; v < numVert; v++) {
+			alt->to[(size_t)v * alt->stride + i] = dist[v];
+		}
+		alt->numLandmarks++;
+
+		for (int v = 0; v < numVert; v++) {
+			int from = alt->from[(size_t)v * alt->stride + i];
+			int to = alt->to[(size_t)v * alt->stride + i];
+
+			if (i == 0) {
+				score[v] = from == UNREACHED || to == UNREACHED ? -1 : (long long)from + to;
+			} else if (score[v] != -1 && (long long)from + to < score[v]) {
+				score[v] = (long long)from + to;
+			}
+		}
+
+		next = farthest(score, numVert);
+		if (score[next] <= 0) {
+			break;			// every candidate is already a landmark
+		}
+	}
+
+	free(dist);
+	free(score);
+
+	return alt;
+}
+
+void AltFree(Alt alt) {
+	free(alt->from);
+	free(alt->to);
+	free(alt->forward.dist);
+	free(alt->forward.touched);
+	PqFree(alt->forward.pq);
+	free(alt->backward.dist);
+	free(alt->backward.touched);
+	PqFree(alt->backward.pq);
+	free(alt);
+}
+
+int AltDistance(Alt alt, int src, int dest, int limit) {
+	assert(src >= 0 && src < GraphNumVertices(alt->g));
+	assert(dest >= 0 && dest < GraphNumVertices(alt->g));
+
+	if (src == dest) {
+		return limit > 0 ? 0 : -1;
+	}
+
+	struct side *forward = &alt->forward;
+	struct side *backward = &alt->backward;
+	int best = limit;		// the shortest path found so far, or limit
+
+	forward->dist[src] = 0;
+	forward->touched[forward->numTouched++] = src;
+	if (boundTo(alt, src, dest) < best) {
+		PqInsert(forward->pq, src, boundTo(alt, src, dest));
+	}
+
+	backward->dist[dest] = 0;
+	backward->touched[backward->numTouched++] = dest;
+	if (boundFrom(alt, src, dest) < best) {
+		PqInsert(backward->pq, dest, boundFrom(alt, src, dest));
+	}
+
+	// with consistent bounds, once either search has nothing left below
+	// best, no shorter path can exist
+	while (PqSize(forward->pq) > 0 && PqSize(backward->pq) > 0) {
+		if (PqPeekPriority(forward->pq) >= best || PqPeekPriority(backward->pq) >= best) {
+			break;
+		}
+
+		if (PqSize(forward->pq) <= PqSize(backward->pq)) {
+			scan(alt, forward, backward, false, src, dest, limit, &best);
+		} else {
+			scan(alt, backward, forward, true, src, dest, limit, &best);
+		}
+	}
+
+	sideReset(forward);
+	sideReset(backward);
+
+	return best < limit ? best : -1;
+}
+
+//////////////////////////////////////////////////////////
+
+// helper function to find the distance from root to every computer along
+// the arcs, or from every computer to root if reverse
+static void sweep(Alt alt, int root, bool reverse, int dist[]) {
+	Graph g = alt->g;
+	Pq pq = alt->forward.pq;
+
+	for (int v = 0; v < GraphNumVertices(g); v++) {
+		dist[v] = UNREACHED;
+	}
+	dist[root] = 0;
+	PqInsert(pq, root, 0);
+
+	while (PqSize(pq) > 0) {
+		int v = PqDelete(pq);
+		GraphArcSpan arcs = reverse ? GraphGetInArcs(g, v) : GraphGetOutArcs(g, v);
+
+		for (int i = 0; i < arcs.count; i++) {
+			int w = arcs.vertices[i];
+			if (dist[v] >= UNREACHED - arcs.costs[i]) {
+				continue;
+			}
+
+			int distNext = dist[v] + arcs.costs[i];
+			if (distNext < dist[w]) {
+				if (dist[w] == UNREACHED) {
+					PqInsert(pq, w, distNext);
+				} else {
+					PqUpdate(pq, w, distNext);
+				}
+				dist[w] = distNext;
+			}
+		}
+	}
+}
+
+// helper function to find the computer with the highest score, taking the
+// lowest numbered on ties
+static int farthest(long long score[], int numVert) {
+	int best = 0;
+	for (int v = 1; v < numVert; v++) {
+		if (score[v] > score[best]) {
+			best = v;
+		}
+	}
+	return best;
+}
+
+// helper function to find a lower bound on the distance from v to t:
+// d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L). Terms
+// with an unknown distance at t are skipped, but an unknown distance at v
+// is used as UNREACHED, which keeps the bound consistent from one computer
+// to the next
+static int boundTo(Alt alt, int v, int t) {
+	const int *fromV = &alt->from[(size_t)v * alt->stride];
+	const int *fromT = &alt->from[(size_t)t * alt->stride];
+	const int *toV = &alt->to[(size_t)v * alt->stride];
+	const int *toT = &alt->to[(size_t)t * alt->stride];
+	int bound = 0;
+
+	for (int i = 0; i < alt->numLandmarks; i++) {
+		if (fromT[i] != UNREACHED && fromT[i] - fromV[i] > bound) {
+			bound = fromT[i] - fromV[i];
+		}
+		if (toT[i] != UNREACHED && toV[i] - toT[i] > bound) {
+			bound = toV[i] - toT[i];
+		}
+	}
+
+	return bound;
+}
+
+// helper function to find a lower bound on the distance from s to v, in
+// the same way with the roles of the ends swapped
+static int boundFrom(Alt alt, int s, int v) {
+	const int *fromS = &alt->from[(size_t)s * alt->stride];
+	const int *fromV = &alt->from[(size_t)v * alt->stride];
+	const int *toS = &alt->to[(size_t)s * alt->stride];
+	const int *toV = &alt->to[(size_t)v * alt->stride];
+	int bound = 0;
+
+	for (int i = 0; i < alt->numLandmarks; i++) {
+		if (fromS[i] != UNREACHED && fromV[i] - fromS[i] > bound) {
+			bound = fromV[i] - fromS[i];
+		}
+		if (toS[i] != UNREACHED && toS[i] - toV[i] > bound) {
+			bound = toS[i] - toV[i];
+		}
+	}
+
+	return bound;
+}
+
+// helper function to scan the next computer of one side of the search,
+// relaxing its arcs (or the arcs into it, if reverse) and noting any
+// shorter path through a computer the other side has reached
+static void scan(Alt alt, struct side *near, struct side *far, bool reverse, int src, int dest, int limit, int *best) {
+	int v = PqDelete(near->pq);
+	GraphArcSpan arcs = reverse ? GraphGetInArcs(alt->g, v) : GraphGetOutArcs(alt->g, v);
+
+	for (int i = 0; i < arcs.count; i++) {
+		int w = arcs.vertices[i];
+		if (near->dist[v] >= limit - arcs.costs[i]) {
+			continue;
+		}
+
+		int distNext = near->dist[v] + arcs.costs[i];
+		if (distNext >= near->dist[w]) {
+			continue;
+		}
+
+		if (near->dist[w] == UNREACHED) {
+			near->touched[near->numTouched++] = w;
+		}
+		near->dist[w] = distNext;
+
+		if (far->dist[w] != UNREACHED && (long long)distNext + far->dist[w] < *best) {
+			*best = distNext + far->dist[w];
+		}
+
+		long long key = (long long)distNext + (reverse ? boundFrom(alt, src, w) : boundTo(alt, w, dest));
+		if (key < *best) {
+			if (PqContains(near->pq, w)) {
+				PqUpdate(near->pq, w, key);
+			} else {
+				PqInsert(near->pq, w, key);
+			}
+		}
+	}
+}
+
+// helper function to set up one side of the search
+static void sideInit(struct side *s, int numVert) {
+	s->dist = malloc(numVert * sizeof(int));
+	s->touched = malloc(numVert * sizeof(int));
+	s->numTouched = 0;
+	s->pq = PqNewWithCapacity(numVert);
+
+	if (numVert > 0 && (s->dist == NULL || s->touched == NULL)) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int v = 0; v < numVert; v++) {
+		s->dist[v] = UNREACHED;
+	}
+}
+
+// helper function to clean up one side after a query
+static void sideReset(struct side *s) {
+	for (int i = 0; i < s->numTouched; i++) {
+		s->dist[s->touched[i]] = UNREACHED;
+	}
+	s->numTouched = 0;
+
+	while (PqSize(s->pq) > 0) {
+		PqDelete(s->pq);
+	}
+}
@@ -0,0 +1,31 @@
+// ALT point-to-point shortest paths
+// Answers single-pair queries over a graph's arcs with a bidirectional A*
+// search. The forward search runs along the arcs from the source and the
+// backward search against them from the destination; both are steered by
+// lower bounds from the triangle inequality on distances to and from a few
+// landmark computers, which are found once when the ALT structure is made.
+// Based on "Computing the shortest path: A* search meets graph theory"
+// (Goldberg and Harrelson, SODA 2005), using their symmetric stopping rule.
+
+#ifndef ALT_H
+#define ALT_H
+
+#include "Graph.h"
+
+typedef struct alt *Alt;
+
+// Picks up to numLandmarks landmarks in g and finds the distances along the
+// arcs from each of them to every computer and from every computer to each
+// of them. Takes O(numLandmarks * (V + E) log V) time and
+// O(numLandmarks * V) space
+// g must not change while the ALT structure is in use
+Alt AltNew(Graph g, int numLandmarks);
+
+// Frees all memory allocated to an ALT structure
+void AltFree(Alt alt);
+
+// Returns the length of a shortest path of arcs from src to dest (the sum
+// of their costs), or -1 if there is no such path shorter than limit
+int AltDistance(Alt alt, int src, int dest, int limit);
+
+#endif
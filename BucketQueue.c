@@ -0,0 +1,166 @@
+// Bucket queue (Dial's algorithm)
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "BucketQueue.h"
+
+#define NONE -1
+
+// Bucket b holds the items whose priority is congruent to b modulo
+// numBuckets, as a doubly linked list threaded through next[] and prev[]
+// (head[b] and tail[b] are its ends). current is the last priority deleted,
+// or NONE before the first insertion. Since every priority in the queue is
+// within maxStep of current, each bucket only ever holds one priority.
+struct bucketQueue {
+	int numItems;
+	int numBuckets;
+	int size;
+	int current;
+	int *head;
+	int *tail;
+	int *next;
+	int *prev;
+	int *priority;
+	bool *inQueue;
+};
+
+static void bucketLink(BucketQueue bq, int item);
+static void bucketUnlink(BucketQueue bq, int item);
+
+BucketQueue BucketQueueNew(int numItems, int maxStep) {
+	assert(maxStep >= 0);
+
+	BucketQueue bq = malloc(sizeof(struct bucketQueue));
+	if (bq == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	bq->numItems = numItems;
+	bq->numBuckets = maxStep + 1;
+	bq->size = 0;
+	bq->current = NONE;
+	bq->head = malloc(bq->numBuckets * sizeof(int));
+	bq->tail = malloc(bq->numBuckets * sizeof(int));
+	bq->next = malloc(numItems * sizeof(int));
+	bq->prev = malloc(numItems * sizeof(int));
+	bq->priority = malloc(numItems * sizeof(int));
+	bq->inQueue = calloc(numItems, sizeof(bool));
+
+	if (bq->head == NULL || bq->tail == NULL || (numItems > 0 && (bq->next == NULL
+	    || bq->prev == NULL || bq->priority == NULL || bq->inQueue == NULL))) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int b = 0; b < bq->numBuckets; b++) {
+		bq->head[b] = NONE;
+		bq->tail[b] = NONE;
+	}
+
+	return bq;
+}
+
+void BucketQueueFree(BucketQueue bq) {
+	free(bq->head);
+	free(bq->tail);
+	free(bq->next);
+	free(bq->prev);
+	free(bq->priority);
+	free(bq->inQueue);
+	free(bq);
+}
+
+void BucketQueueInsert(BucketQueue bq, int item, int priority) {
+	assert(item >= 0 && item < bq->numItems && !bq->inQueue[item]);
+
+	if (bq->current == NONE) {
+		bq->current = priority;
+	}
+	assert(priority >= bq->current && priority - bq->current < bq->numBuckets);
+
+	bq->priority[item] = priority;
+	bq->inQueue[item] = true;
+	bucketLink(bq, item);
+	bq->size++;
+}
+
+void BucketQueueUpdate(BucketQueue bq, int item, int priority) {
+	assert(BucketQueueContains(bq, item));
+	assert(priority >= bq->current && priority <= bq->priority[item]);
+
+	bucketUnlink(bq, item);
+	bq->priority[item] = priority;
+	bucketLink(bq, item);
+}
+
+bool BucketQueueContains(BucketQueue bq, int item) {
+	return item >= 0 && item < bq->numItems && bq->inQueue[item];
+}
+
+int BucketQueueSize(BucketQueue bq) {
+	return bq->size;
+}
+
+int BucketQueueDelete(BucketQueue bq) {
+	if (bq->size == 0) {
+		fprintf(stderr, "error: bucket queue is empty\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// walk forward to the next non-empty bucket; at most numBuckets steps
+	int b = bq->current % bq->numBuckets;
+	while (bq->head[b] == NONE) {
+		bq->current++;
+		b = b + 1 == bq->numBuckets ? 0 : b + 1;
+	}
+
+	int item = bq->head[b];
+	bucketUnlink(bq, item);
+	bq->inQueue[item] = false;
+	bq->size--;
+
+	return item;
+}
+
+void BucketQueueClear(BucketQueue bq) {
+	while (bq->size > 0) {
+		BucketQueueDelete(bq);
+	}
+	bq->current = NONE;
+}
+
+//////////////////////////////////////////////////////////
+
+// helper function to append an item to the end of its bucket
+static void bucketLink(BucketQueue bq, int item) {
+	int b = bq->priority[item] % bq->numBuckets;
+
+	bq->next[item] = NONE;
+	bq->prev[item] = bq->tail[b];
+	if (bq->tail[b] == NONE) {
+		bq->head[b] = item;
+	} else {
+		bq->next[bq->tail[b]] = item;
+	}
+	bq->tail[b] = item;
+}
+
+// helper function to remove an item from its bucket
+static void bucketUnlink(BucketQueue bq, int item) {
+	int b = bq->priority[item] % bq->numBuckets;
+
+	if (bq->prev[item] == NONE) {
+		bq->head[b] = bq->next[item];
+	} else {
+		bq->next[bq->prev[item]] = bq->next[item];
+	}
+	if (bq->next[item] == NONE) {
+		bq->tail[b] = bq->prev[item];
+	} else {
+		bq->prev[bq->next[item]] = bq->prev[item];
+	}
+}
@@ -0,0 +1,42 @@
+// Bucket queue (Dial's algorithm)
+// A monotone priority queue for small non-negative integer priorities. It
+// keeps one bucket per priority in a circular array of maxStep + 1 buckets,
+// which is enough as long as every priority inserted lies within maxStep
+// of the smallest priority in the queue, as in Dijkstra's algorithm where
+// no edge costs more than maxStep.
+
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <stdbool.h>
+
+typedef struct bucketQueue *BucketQueue;
+
+// Creates a bucket queue for the items 0 .. numItems - 1
+BucketQueue BucketQueueNew(int numItems, int maxStep);
+
+// Frees all memory allocated to a bucket queue
+void BucketQueueFree(BucketQueue bq);
+
+// Inserts an item that is not in the queue
+// Assumes 0 <= min <= priority <= min + maxStep, where min is the last
+// priority deleted (or the first priority ever inserted)
+void BucketQueueInsert(BucketQueue bq, int item, int priority);
+
+// Lowers the priority of an item already in the queue
+void BucketQueueUpdate(BucketQueue bq, int item, int priority);
+
+// Returns true if the item is currently in the queue
+bool BucketQueueContains(BucketQueue bq, int item);
+
+// Returns the number of items in the queue
+int BucketQueueSize(BucketQueue bq);
+
+// Removes and returns an item with the smallest priority
+// Items with equal priorities come out in insertion order
+int BucketQueueDelete(BucketQueue bq);
+
+// Removes every item, after which the queue accepts any priority again
+void BucketQueueClear(BucketQueue bq);
+
+#endif
@@ -0,0 +1,556 @@
+// Contraction hierarchies
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ContractionHierarchy.h"
+#include "PriorityQueue.h"
+
+// A distance of INT_MAX or more. Queries never return one, so a shortcut
+// that long would never be used and is not added
+#define UNREACHED INT_MAX
+
+// Witness searches give up after settling this many computers, adding the
+// shortcut as if no witness had been found. That keeps preprocessing fast
+// at the cost of a few unneeded shortcuts. Searches that only estimate how
+// many shortcuts a contraction needs give up sooner
+#define WITNESS_SETTLE_LIMIT 64
+#define ESTIMATE_SETTLE_LIMIT 16
+
+// Contraction stops once the computers left have more than this many arcs
+// each on average. In networks without much hierarchy (random ones, say)
+// the last few computers would otherwise end up joined to nearly every
+// other, and contracting each of them would take longer than the rest put
+// together. The computers left form a core whose arcs queries follow in
+// both directions, as in a plain bidirectional search
+#define CORE_DEGREE 64
+
+// A growable list of arcs
+struct arcList {
+	int *vertices;
+	int *costs;
+	int size;
+	int capacity;
+};
+
+// One direction of a query. dist is UNREACHED outside of a query, which
+// only resets the computers listed in touched
+struct side {
+	int *dist;
+	int *touched;
+	int numTouched;
+	Pq pq;
+};
+
+// The upward arcs in CSR form: up holds each computer's arcs to computers
+// contracted after it, and down holds the arcs into each computer from
+// computers contracted after it, which the backward search follows.
+// Computers are numbered by when they were contracted, so the few that
+// every query reaches sit together in memory
+struct contractionHierarchy {
+	int numVert;
+	int numShortcuts;
+	int *rank;				// the number of each computer in the hierarchy
+	int *upOffsets;
+	int *upVertices;
+	int *upCosts;
+	int *downOffsets;
+	int *downVertices;
+	int *downCosts;
+	struct side forward;
+	struct side backward;
+};
+
+// The state of preprocessing: the arcs between computers not yet
+// contracted, the arcs each contracted computer had when it went, and a
+// search used to look for witnesses
+struct contraction {
+	int numVert;
+	struct arcList *out;
+	struct arcList *in;
+	struct arcList *up;
+	struct arcList *down;
+	int *numDeleted;		// contracted neighbours, which spreads contraction evenly
+	bool *isTarget;			// the computers the current witness searches are for
+	long long numArcs;		// between computers not yet contracted
+	int numShortcuts;
+	struct side witness;
+};
+
+static int contract(struct contraction *c, int v, bool apply);
+static int priority(struct contraction *c, int v);
+static void witnessSearch(struct contraction *c, int src, int skip, int maxDist, int numTargets, int settleLimit);
+static void removeVertex(struct contraction *c, int v);
+static void toCsr(struct arcList lists[], int numVert, int order[], int rank[], int **offsets, int **vertices, int **costs);
+static void settle(ContractionHierarchy ch, struct side *near, struct side *far, bool backward, int limit, int *best);
+static void arcListAdd(struct arcList *l, int v, int cost);
+static bool arcListLower(struct arcList *l, int v, int cost);
+static void arcListRemove(struct arcList *l, int v);
+static void sideInit(struct side *s, int numVert);
+static void sideFree(struct side *s);
+static void sideReset(struct side *s);
+
+ContractionHierarchy ChNew(Graph g) {
+	int numVert = GraphNumVertices(g);
+
+	struct contraction c;
+	c.numVert = numVert;
+	c.out = calloc(numVert, sizeof(struct arcList));
+	c.in = calloc(numVert, sizeof(struct arcList));
+	c.up = calloc(numVert, sizeof(struct arcList));
+	c.down = calloc(numVert, sizeof(struct arcList));
+	c.numDeleted = calloc(numVert, sizeof(int));
+	c.isTarget = calloc(numVert, sizeof(bool));
+	c.numArcs = 0;
+	c.numShortcuts = 0;
+	sideInit(&c.witness, numVert);
+
+	if (numVert > 0 && (c.out == NULL || c.in == NULL || c.up == NULL || c.down == NULL || c.numDeleted == NULL || c.isTarget == NULL)) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// the graph's arcs are already unique, and a loop never shortens a path
+	for (int v = 0; v < numVert; v++) {
+		GraphArcSpan arcs = GraphGetOutArcs(g, v);
+		for (int i = 0; i < arcs.count; i++) {
+			int w = arcs.vertices[i];
+			if (w != v) {
+				arcListAdd(&c.out[v], w, arcs.costs[i]);
+				arcListAdd(&c.in[w], v, arcs.costs[i]);
+				c.numArcs++;
+			}
+		}
+	}
+
+	ContractionHierarchy ch = malloc(sizeof(struct contractionHierarchy));
+	int *order = malloc(numVert * sizeof(int));
+	if (ch == NULL || (numVert > 0 && order == NULL)) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	ch->numVert = numVert;
+	ch->rank = malloc(numVert * sizeof(int));
+	if (numVert > 0 && ch->rank == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// contract the computer with the lowest priority, rechecking it first
+	// since its priority may have gone up since it was queued. neighbours
+	// are not rechecked after each contraction: with the lazy check that
+	// gives hierarchies just as good, and rechecking the neighbours of the
+	// well connected computers contracted last is what would take longest
+	Pq queue = PqNewWithCapacity(numVert);
+	for (int v = 0; v < numVert; v++) {
+		PqInsert(queue, v, priority(&c, v));
+	}
+
+	int numContracted = 0;
+	while (PqSize(queue) > 0 && c.numArcs <= (long long)CORE_DEGREE * PqSize(queue)) {
+		int v = PqDelete(queue);
+		int current = priority(&c, v);
+		if (PqSize(queue) > 0 && current > PqPeekPriority(queue)) {
+			PqInsert(queue, v, current);
+			continue;
+		}
+
+		contract(&c, v, true);
+		removeVertex(&c, v);
+		ch->rank[v] = numContracted;
+		order[numContracted++] = v;
+	}
+
+	// the core keeps all of its arcs, as both upward and downward arcs
+	while (PqSize(queue) > 0) {
+		int v = PqDelete(queue);
+		c.up[v] = c.out[v];
+		c.down[v] = c.in[v];
+		c.out[v] = (struct arcList){NULL, NULL, 0, 0};
+		c.in[v] = (struct arcList){NULL, NULL, 0, 0};
+		ch->rank[v] = numContracted;
+		order[numContracted++] = v;
+	}
+	PqFree(queue);
+
+	ch->numShortcuts = c.numShortcuts;
+	toCsr(c.up, numVert, order, ch->rank, &ch->upOffsets, &ch->upVertices, &ch->upCosts);
+	toCsr(c.down, numVert, order, ch->rank, &ch->downOffsets, &ch->downVertices, &ch->downCosts);
+	free(order);
+	sideInit(&ch->forward, numVert);
+	sideInit(&ch->backward, numVert);
+
+	for (int v = 0; v < numVert; v++) {
+		free(c.out[v].vertices);
+		free(c.out[v].costs);
+		free(c.in[v].vertices);
+		free(c.in[v].costs);
+	}
+	free(c.out);
+	free(c.in);
+	free(c.up);
+	free(c.down);
+	free(c.numDeleted);
+	free(c.isTarget);
+	sideFree(&c.witness);
+
+	return ch;
+}
+
+void ChFree(ContractionHierarchy ch) {
+	free(ch->rank);
+	free(ch->upOffsets);
+	free(ch->upVertices);
+	free(ch->upCosts);
+	free(ch->downOffsets);
+	free(ch->downVertices);
+	free(ch->downCosts);
+	sideFree(&ch->forward);
+	sideFree(&ch->backward);
+	free(ch);
+}
+
+int ChDistance(ContractionHierarchy ch, int src, int dest, int limit) {
+	assert(src >= 0 && src < ch->numVert);
+	assert(dest >= 0 && dest < ch->numVert);
+
+	if (limit <= 0) {
+		return -1;
+	}
+
+	struct side *forward = &ch->forward;
+	struct side *backward = &ch->backward;
+	int best = limit;		// the shortest path found so far, or limit
+
+	src = ch->rank[src];
+	dest = ch->rank[dest];
+
+	forward->dist[src] = 0;
+	forward->touched[forward->numTouched++] = src;
+	PqInsert(forward->pq, src, 0);
+
+	backward->dist[dest] = 0;
+	backward->touched[backward->numTouched++] = dest;
+	PqInsert(backward->pq, dest, 0);
+
+	if (src == dest) {
+		best = 0;
+	}
+
+	// each side stops once everything left in it is at least best away,
+	// since the shortest path meets at its highest computer, which both
+	// sides reach along upward arcs
+	bool forwardDone = false;
+	bool backwardDone = false;
+	while (!forwardDone || !backwardDone) {
+		if (!forwardDone) {
+			forwardDone = PqSize(forward->pq) == 0 || PqPeekPriority(forward->pq) >= best;
+			if (!forwardDone) {
+				settle(ch, forward, backward, false, limit, &best);
+			}
+		}
+		if (!backwardDone) {
+			backwardDone = PqSize(backward->pq) == 0 || PqPeekPriority(backward->pq) >= best;
+			if (!backwardDone) {
+				settle(ch, backward, forward, true, limit, &best);
+			}
+		}
+	}
+
+	sideReset(forward);
+	sideReset(backward);
+
+	return best < limit ? best : -1;
+}
+
+int ChNumShortcuts(ContractionHierarchy ch) {
+	return ch->numShortcuts;
+}
+
+//////////////////////////////////////////////////////////
+
+// helper function to contract v: for every pair of arcs u -> v -> w, adds
+// a shortcut u -> w unless a search from u finds another path to w that
+// is no longer. If apply is false nothing is added. Returns the number of
+// shortcuts needed
+static int contract(struct contraction *c, int v, bool apply) {
+	struct arcList *in = &c->in[v];
+	struct arcList *out = &c->out[v];
+	int numShortcuts = 0;
+
+	for (int j = 0; j < out->size; j++) {
+		c->isTarget[out->vertices[j]] = true;
+	}
+
+	for (int i = 0; i < in->size; i++) {
+		int u = in->vertices[i];
+
+		int maxVia = -1;
+		int numTargets = 0;
+		for (int j = 0; j < out->size; j++) {
+			long long via = (long long)in->costs[i] + out->costs[j];
+			if (out->vertices[j] != u) {
+				numTargets++;
+				if (via < UNREACHED && via > maxVia) {
+					maxVia = via;
+				}
+			}
+		}
+		if (maxVia == -1) {
+			continue;
+		}
+
+		witnessSearch(c, u, v, maxVia, numTargets, apply ? WITNESS_SETTLE_LIMIT : ESTIMATE_SETTLE_LIMIT);
+
+		for (int j = 0; j < out->size; j++) {
+			int w = out->vertices[j];
+			long long via = (long long)in->costs[i] + out->costs[j];
+
+			if (w != u && via < UNREACHED && c->witness.dist[w] > via) {
+				numShortcuts++;
+				if (apply) {
+					if (arcListLower(&c->out[u], w, via)) {
+						c->numArcs++;
+						c->numShortcuts++;
+					}
+					arcListLower(&c->in[w], u, via);
+				}
+			}
+		}
+
+		sideReset(&c->witness);
+	}
+
+	for (int j = 0; j < out->size; j++) {
+		c->isTarget[out->vertices[j]] = false;
+	}
+
+	return numShortcuts;
+}
+
+// helper function to find how much contracting v would cost: the shortcuts
+// it needs less the arcs it removes, plus its contracted neighbours
+static int priority(struct contraction *c, int v) {
+	return contract(c, v, false) - c->in[v].size - c->out[v].size + c->numDeleted[v];
+}
+
+// helper function to search from src without passing through skip, until
+// every target or every computer within maxDist has been settled, or
+// settleLimit computers have. The distances found are left in the witness
+// side
+static void witnessSearch(struct contraction *c, int src, int skip, int maxDist, int numTargets, int settleLimit) {
+	struct side *s = &c->witness;
+
+	s->dist[src] = 0;
+	s->touched[s->numTouched++] = src;
+	PqInsert(s->pq, src, 0);
+
+	for (int settled = 0; settled < settleLimit && numTargets > 0 && PqSize(s->pq) > 0; settled++) {
+		if (PqPeekPriority(s->pq) > maxDist) {
+			break;
+		}
+
+		int v = PqDelete(s->pq);
+		if (c->isTarget[v] && v != src) {
+			numTargets--;
+		}
+		struct arcList *out = &c->out[v];
+
+		for (int i = 0; i < out->size; i++) {
+			int w = out->vertices[i];
+			if (w == skip || s->dist[v] > maxDist - out->costs[i]) {
+				continue;
+			}
+
+			int distNext = s->dist[v] + out->costs[i];
+			if (distNext < s->dist[w]) {
+				if (s->dist[w] == UNREACHED) {
+					s->touched[s->numTouched++] = w;
+					PqInsert(s->pq, w, distNext);
+				} else {
+					PqUpdate(s->pq, w, distNext);
+				}
+				s->dist[w] = distNext;
+			}
+		}
+	}
+}
+
+// helper function to take a contracted computer out of the remaining
+// graph, keeping its arcs as its upward arcs
+static void removeVertex(struct contraction *c, int v) {
+	c->up[v] = c->out[v];
+	c->down[v] = c->in[v];
+	c->out[v] = (struct arcList){NULL, NULL, 0, 0};
+	c->in[v] = (struct arcList){NULL, NULL, 0, 0};
+	c->numArcs -= c->up[v].size + c->down[v].size;
+
+	for (int i = 0; i < c->up[v].size; i++) {
+		arcListRemove(&c->in[c->up[v].vertices[i]], v);
+		c->numDeleted[c->up[v].vertices[i]]++;
+	}
+	for (int i = 0; i < c->down[v].size; i++) {
+		arcListRemove(&c->out[c->down[v].vertices[i]], v);
+		c->numDeleted[c->down[v].vertices[i]]++;
+	}
+}
+
+// helper function to pack arc lists into CSR arrays in the order given,
+// renumbering computers by rank, and free the lists
+static void toCsr(struct arcList lists[], int numVert, int order[], int rank[], int **offsets, int **vertices, int **costs) {
+	*offsets = malloc((numVert + 1) * sizeof(int));
+	if (*offsets == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	(*offsets)[0] = 0;
+	for (int r = 0; r < numVert; r++) {
+		(*offsets)[r + 1] = (*offsets)[r] + lists[order[r]].size;
+	}
+
+	*vertices = malloc((*offsets)[numVert] * sizeof(int));
+	*costs = malloc((*offsets)[numVert] * sizeof(int));
+	if ((*offsets)[numVert] > 0 && (*vertices == NULL || *costs == NULL)) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int r = 0; r < numVert; r++) {
+		struct arcList *l = &lists[order[r]];
+		for (int i = 0; i < l->size; i++) {
+			(*vertices)[(*offsets)[r] + i] = rank[l->vertices[i]];
+			(*costs)[(*offsets)[r] + i] = l->costs[i];
+		}
+		free(l->vertices);
+		free(l->costs);
+	}
+}
+
+// helper function to settle the next computer of one side of a query,
+// noting the path through it if the other side has reached it, and
+// relaxing its upward arcs. A computer that this side reaches sooner
+// through a downward arc from a computer above it is not on any shortest
+// path upwards, so its arcs are left alone (stall-on-demand)
+static void settle(ContractionHierarchy ch, struct side *near, struct side *far, bool backward, int limit, int *best) {
+	int v = PqDelete(near->pq);
+	if (far->dist[v] != UNREACHED && (long long)near->dist[v] + far->dist[v] < *best) {
+		*best = near->dist[v] + far->dist[v];
+	}
+
+	int *offsets = backward ? ch->downOffsets : ch->upOffsets;
+	int *vertices = backward ? ch->downVertices : ch->upVertices;
+	int *costs = backward ? ch->downCosts : ch->upCosts;
+	int *stallOffsets = backward ? ch->upOffsets : ch->downOffsets;
+	int *stallVertices = backward ? ch->upVertices : ch->downVertices;
+	int *stallCosts = backward ? ch->upCosts : ch->downCosts;
+
+	for (int i = stallOffsets[v]; i < stallOffsets[v + 1]; i++) {
+		int u = stallVertices[i];
+		if (near->dist[u] != UNREACHED && near->dist[u] < near->dist[v] - stallCosts[i]) {
+			return;
+		}
+	}
+
+	for (int i = offsets[v]; i < offsets[v + 1]; i++) {
+		int w = vertices[i];
+		if (near->dist[v] >= limit - costs[i]) {
+			continue;
+		}
+
+		int distNext = near->dist[v] + costs[i];
+		if (distNext < near->dist[w]) {
+			if (near->dist[w] == UNREACHED) {
+				near->touched[near->numTouched++] = w;
+				PqInsert(near->pq, w, distNext);
+			} else {
+				PqUpdate(near->pq, w, distNext);
+			}
+			near->dist[w] = distNext;
+		}
+	}
+}
+
+// helper function to append an arc to a list
+static void arcListAdd(struct arcList *l, int v, int cost) {
+	if (l->size == l->capacity) {
+		l->capacity = l->capacity == 0 ? 4 : 2 * l->capacity;
+		l->vertices = realloc(l->vertices, l->capacity * sizeof(int));
+		l->costs = realloc(l->costs, l->capacity * sizeof(int));
+		if (l->vertices == NULL || l->costs == NULL) {
+			fprintf(stderr, "error: out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	l->vertices[l->size] = v;
+	l->costs[l->size++] = cost;
+}
+
+// helper function to add an arc to a list, or lower the cost of the arc
+// to the same computer if the list already has one. Returns true if the
+// arc was added
+static bool arcListLower(struct arcList *l, int v, int cost) {
+	for (int i = 0; i < l->size; i++) {
+		if (l->vertices[i] == v) {
+			if (cost < l->costs[i]) {
+				l->costs[i] = cost;
+			}
+			return false;
+		}
+	}
+	arcListAdd(l, v, cost);
+	return true;
+}
+
+// helper function to remove the arc to v from a list
+static void arcListRemove(struct arcList *l, int v) {
+	for (int i = 0; i < l->size; i++) {
+		if (l->vertices[i] == v) {
+			l->size--;
+			l->vertices[i] = l->vertices[l->size];
+			l->costs[i] = l->costs[l->size];
+			return;
+		}
+	}
+}
+
+// helper function to set up one side of a search
+static void sideInit(struct side *s, int numVert) {
+	s->dist = malloc(numVert * sizeof(int));
+	s->touched = malloc(numVert * sizeof(int));
+	s->numTouched = 0;
+	s->pq = PqNewWithCapacity(numVert);
+
+	if (numVert > 0 && (s->dist == NULL || s->touched == NULL)) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int v = 0; v < numVert; v++) {
+		s->dist[v] = UNREACHED;
+	}
+}
+
+// helper function to free one side of a search
+static void sideFree(struct side *s) {
+	free(s->dist);
+	free(s->touched);
+	PqFree(s->pq);
+}
+
+// helper function to clean up one side after a search
+static void sideReset(struct side *s) {
+	for (int i = 0; i < s->numTouched; i++) {
+		s->dist[s->touched[i]] = UNREACHED;
+	}
+	s->numTouched = 0;
+
+	while (PqSize(s->pq) > 0) {
+		PqDelete(s->pq);
+	}
+}
@@ -0,0 +1,36 @@
+// Contraction hierarchies
+// Preprocesses a graph's arcs so that single-pair shortest path queries only
+// have to look at a tiny part of it. Computers are contracted one at a time,
+// least important first: contracting v removes it, adding a shortcut u -> w
+// wherever u -> v -> w was the only shortest path left from u to w. A query
+// then runs a search upwards (towards computers contracted later) from both
+// ends, along the original arcs and the shortcuts. Contraction stops early
+// if what is left of the network becomes dense, and queries search that
+// core in full.
+// Based on "Contraction Hierarchies: Faster and Simpler Hierarchical Routing
+// in Road Networks" (Geisberger, Sanders, Schultes and Delling, WEA 2008)
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "Graph.h"
+
+typedef struct contractionHierarchy *ContractionHierarchy;
+
+// Builds a contraction hierarchy over the arcs of g. This takes far longer
+// than a single search, but only has to be done once. The hierarchy is a
+// copy, so g may change or be freed afterwards (though the hierarchy will
+// keep answering for the graph as it was)
+ContractionHierarchy ChNew(Graph g);
+
+// Frees all memory allocated to a contraction hierarchy
+void ChFree(ContractionHierarchy ch);
+
+// Returns the length of a shortest path of arcs from src to dest (the sum
+// of their costs), or -1 if there is no such path shorter than limit
+int ChDistance(ContractionHierarchy ch, int src, int dest, int limit);
+
+// Returns the number of shortcuts the hierarchy added
+int ChNumShortcuts(ContractionHierarchy ch);
+
+#endif
@@ -0,0 +1,277 @@
+// Parallel delta-stepping shortest paths
+
+#include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DeltaStepping.h"
+
+// A growable list of computers
+struct list {
+	int *items;
+	int size;
+	int capacity;
+};
+
+// Shared state of one search. dist[] is read and lowered by every thread
+// with atomic operations; everything else is only written by thread 0
+// between barriers. Pending computers sit in a circular array of buckets:
+// bucket b (times in [b * delta, (b + 1) * delta)) is slots[b % numSlots],
+// which is enough slots because no pending time is more than one maximum
+// step past the current bucket.
+struct search {
+	Graph g;
+	int *dist;
+	int delta;
+	int numThreads;
+
+	struct list *slots;
+	int numSlots;
+	int current;			// index of the bucket being emptied
+	bool heavy;				// whether the frontier is being relaxed along heavy steps
+	bool done;
+
+	int *expandedAt;		// the time v had when its light steps were last relaxed, or -1
+	int *settledIn;			// the last bucket v was settled in, or -1
+	struct list settled;	// computers settled in the current bucket, for the heavy phase
+	struct list frontier;	// computers every thread relaxes a share of in this phase
+
+	struct list *improved;	// per thread: computers whose time it lowered in this phase
+	pthread_barrier_t barrier;
+};
+
+struct worker {
+	struct search *s;
+	int id;
+};
+
+static void *work(void *arg);
+static void relax(struct search *s, int id);
+static bool prepare(struct search *s);
+static bool takeBucket(struct search *s);
+static int chooseDelta(Graph g);
+static void listPush(struct list *l, int item);
+
+void DeltaStepping(Graph g, int src, int dist[], int numThreads) {
+	assert(numThreads >= 1);
+
+	int numVert = GraphNumVertices(g);
+	for (int v = 0; v < numVert; v++) {
+		dist[v] = INT_MAX;
+	}
+
+	struct search s = {0};
+	s.g = g;
+	s.dist = dist;
+	s.numThreads = numThreads;
+
+	s.delta = chooseDelta(g);
+	s.numSlots = GraphMaxArcCost(g) / s.delta + 2;
+	s.slots = calloc(s.numSlots, sizeof(struct list));
+	s.expandedAt = malloc(numVert * sizeof(int));
+	s.settledIn = malloc(numVert * sizeof(int));
+	s.improved = calloc(numThreads, sizeof(struct list));
+
+	if (s.slots == NULL || s.improved == NULL || (numVert > 0 && (s.expandedAt == NULL || s.settledIn == NULL))) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int v = 0; v < numVert; v++) {
+		s.expandedAt[v] = -1;
+		s.settledIn[v] = -1;
+	}
+
+	dist[src] = GraphGetPoodleTime(g, src);
+	s.current = dist[src] / s.delta;
+	listPush(&s.slots[s.current % s.numSlots], src);
+	s.done = !prepare(&s);
+
+	pthread_barrier_init(&s.barrier, NULL, numThreads);
+
+	pthread_t *threads = malloc(numThreads * sizeof(pthread_t));
+	struct worker *workers = malloc(numThreads * sizeof(struct worker));
+	if (threads == NULL || workers == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int t = 0; t < numThreads; t++) {
+		workers[t].s = &s;
+		workers[t].id = t;
+	}
+	for (int t = 1; t < numThreads; t++) {
+		if (pthread_create(&threads[t], NULL, work, &workers[t]) != 0) {
+			fprintf(stderr, "error: failed to create thread\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	work(&workers[0]);
+
+	for (int t = 1; t < numThreads; t++) {
+		pthread_join(threads[t], NULL);
+	}
+
+	pthread_barrier_destroy(&s.barrier);
+
+	for (int b = 0; b < s.numSlots; b++) {
+		free(s.slots[b].items);
+	}
+	for (int t = 0; t < numThreads; t++) {
+		free(s.improved[t].items);
+	}
+	free(s.slots);
+	free(s.improved);
+	free(s.expandedAt);
+	free(s.settledIn);
+	free(s.settled.items);
+	free(s.frontier.items);
+	free(threads);
+	free(workers);
+}
+
+//////////////////////////////////////////////////////////
+
+// helper function run by every thread: relax a share of each phase's
+// frontier, then wait while thread 0 sets up the next phase
+static void *work(void *arg) {
+	struct worker *w = arg;
+	struct search *s = w->s;
+
+	while (!s->done) {
+		relax(s, w->id);
+		pthread_barrier_wait(&s->barrier);
+
+		if (w->id == 0) {
+			s->done = !prepare(s);
+		}
+		pthread_barrier_wait(&s->barrier);
+	}
+
+	return NULL;
+}
+
+// helper function to relax the light or heavy steps out of this thread's
+// contiguous share of the frontier
+static void relax(struct search *s, int id) {
+	Graph g = s->g;
+	int first = (int)((long long)s->frontier.size * id / s->numThreads);
+	int last = (int)((long long)s->frontier.size * (id + 1) / s->numThreads);
+
+	for (int f = first; f < last; f++) {
+		int v = s->frontier.items[f];
+		int distV = __atomic_load_n(&s->dist[v], __ATOMIC_RELAXED);
+		GraphArcSpan arcs = GraphGetOutArcs(g, v);
+
+		for (int i = 0; i < arcs.count; i++) {
+			int w = arcs.vertices[i];
+			int cost = arcs.costs[i];
+			if ((cost > s->delta) != s->heavy || distV > INT_MAX - cost) {
+				continue;
+			}
+
+			int distNext = distV + cost;
+			int old = __atomic_load_n(&s->dist[w], __ATOMIC_RELAXED);
+			while (distNext < old) {
+				if (__atomic_compare_exchange_n(&s->dist[w], &old, distNext, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+					listPush(&s->improved[id], w);
+					break;
+				}
+			}
+		}
+	}
+}
+
+// helper function run by thread 0 between phases: file the computers
+// improved in the last phase into their buckets, then choose the next
+// frontier. Returns false once every bucket is empty
+static bool prepare(struct search *s) {
+	for (int t = 0; t < s->numThreads; t++) {
+		struct list *improved = &s->improved[t];
+		for (int i = 0; i < improved->size; i++) {
+			int w = improved->items[i];
+			listPush(&s->slots[(s->dist[w] / s->delta) % s->numSlots], w);
+		}
+		improved->size = 0;
+	}
+
+	if (!s->heavy && takeBucket(s)) {
+		return true;
+	}
+
+	// the current bucket has stopped changing: relax its heavy steps once,
+	// which can only reach later buckets
+	if (!s->heavy && s->settled.size > 0) {
+		struct list frontier = s->frontier;
+		s->frontier = s->settled;
+		s->settled = frontier;
+		s->settled.size = 0;
+		s->heavy = true;
+		return true;
+	}
+
+	// no time is past INT_MAX, so no bucket is past INT_MAX / delta, and
+	// stopping there keeps current from overflowing
+	s->heavy = false;
+	for (int step = 1; step <= s->numSlots && s->current < INT_MAX / s->delta; step++) {
+		s->current++;
+		if (takeBucket(s)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// helper function to make the current bucket's computers that need their
+// light steps relaxed the frontier. Returns false if there are none
+static bool takeBucket(struct search *s) {
+	struct list *slot = &s->slots[s->current % s->numSlots];
+	s->frontier.size = 0;
+
+	for (int i = 0; i < slot->size; i++) {
+		int v = slot->items[i];
+		if (s->dist[v] / s->delta != s->current || s->expandedAt[v] == s->dist[v]) {
+			continue;
+		}
+
+		s->expandedAt[v] = s->dist[v];
+		listPush(&s->frontier, v);
+		if (s->settledIn[v] != s->current) {
+			s->settledIn[v] = s->current;
+			listPush(&s->settled, v);
+		}
+	}
+	slot->size = 0;
+
+	return s->frontier.size > 0;
+}
+
+// helper function to pick the bucket width: the largest step cost divided
+// by the average number of arcs out of a computer, so a bucket holds about
+// one step out of each computer
+static int chooseDelta(Graph g) {
+	int numVert = GraphNumVertices(g);
+	long long averageDegree = numVert > 0 ? (long long)GraphNumArcs(g) / numVert : 0;
+	long long delta = GraphMaxArcCost(g) / (averageDegree > 1 ? averageDegree : 1);
+
+	return delta > 0 ? delta : 1;
+}
+
+// helper function to append an item to a list
+static void listPush(struct list *l, int item) {
+	if (l->size == l->capacity) {
+		l->capacity = l->capacity == 0 ? 16 : 2 * l->capacity;
+		l->items = realloc(l->items, l->capacity * sizeof(int));
+		if (l->items == NULL) {
+			fprintf(stderr, "error: out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	l->items[l->size++] = item;
+}
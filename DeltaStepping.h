@@ -0,0 +1,22 @@
+// Parallel delta-stepping shortest paths
+// Computes the same poodle times as task 3's dijkstra using several threads.
+// Times are grouped into buckets of width delta; all the computers in the
+// lowest bucket are relaxed at once, split between the threads, first along
+// the cheap ("light", cost <= delta) steps until the bucket stops changing
+// and then along the expensive ("heavy") ones.
+// Based on "Delta-stepping: a parallelizable shortest path algorithm"
+// (Meyer and Sanders, Journal of Algorithms 2003)
+
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include "Graph.h"
+
+// Sets dist[v] to the earliest time computer v can be poodled when src is
+// poodled first, or INT_MAX if it can never be, using numThreads threads
+// (the calling thread is one of them). A step from v to a neighbour w is
+// allowed if w's security level is at most one more than v's, and costs
+// the transmission time plus w's poodle time.
+void DeltaStepping(Graph g, int src, int dist[], int numThreads);
+
+#endif
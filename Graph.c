@@ -3,59 +3,181 @@
 // modified to fit subsets and other functions created
 
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "Graph.h"
 
+// Adjacency is stored in compressed sparse row (CSR) form: the half-edges of
+// vertex v occupy [offsets[v], offsets[v + 1]) of neighbours[] and
+// transmissionTimes[], so a neighbour walk is a scan of two contiguous arrays.
+// Vertex attributes are kept as one array per attribute, indexed by vertex.
+// The directed arcs are compiled into two more CSR structures, one by
+// sending vertex (out) and one by receiving vertex (in), and are rebuilt
+// whenever the graph changes, or once at the end of a batch of changes. Only
+// the rows of the vertices a change touches are rebuilt; the rest are moved along in place.
+struct arcs {
+    int *offsets;
+    int *vertices;
+    int *costs;
+};
+
+// One arc of a row, so that a row can be sorted by vertex with its costs
+struct arc {
+    int vertex;
+    int cost;
+};
+
 struct graph {
     int nV;
     int nE;
-    Vertex *vertices;
-    struct adjNode **edges;
-};
-
-struct adjNode {
-    Vertex vertex;
-    int transmissionTime;
-    struct adjNode *next;
+    unsigned char *securityLevels;
+    int *poodleTimes;
+    int *offsets;
+    int *neighbours;
+    int *transmissionTimes;
+    int capacity;
+    struct arcs out;
+    struct arcs in;
+    int maxArcCost;
+    bool changing;      // in a batch of changes, so the arcs are out of date
+    bool *isChanged;    // the vertices whose rows of arcs are out of date
+    int *changed;       // likewise, as a list
+    int numChanged;
 };
 
 static bool validVertex(Graph g, int v);
+static bool *firstConnections(int nV, struct connection connections[], int numConnections);
+static void countingSort(int order[], int sorted[], int keys[], int n, int numKeys);
+static int findHalfEdge(Graph g, int v, int w);
+static void reserveHalfEdges(Graph g, int capacity);
+static void insertHalfEdge(Graph g, int v, int w, int transmissionTime);
+static void removeHalfEdge(Graph g, int v, int index);
+static void compileArcs(Graph g);
+static void markChanged(Graph g, int v);
+static void updateArcs(Graph g);
+static void patchArcs(Graph g, struct arcs *a, bool out, int growth[]);
+static void moveRun(struct arcs *a, int from, int to, int count);
+static void reserveArcs(struct arcs *a, int numArcs);
+static int compareInts(const void *a, const void *b);
+static int fillRow(Graph g, int v, bool out, int vertices[], int costs[]);
+static void sortRow(int vertices[], int costs[], int count);
+static int compareArcs(const void *a, const void *b);
+static void freeArcs(struct arcs *a);
+static GraphArcSpan arcSpan(struct arcs *a, int v);
 
 // Returns a new graph with nV vertices
 Graph GraphNew(int nV) {
     Graph g = malloc(sizeof(struct graph));
-    g->edges = calloc(nV, sizeof(struct adjNode *));
-    g->vertices = calloc(nV, sizeof(Vertex));
+    if (g == NULL) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    g->offsets = calloc(nV + 1, sizeof(int));
+    g->securityLevels = calloc(nV, sizeof(unsigned char));
+    g->poodleTimes = calloc(nV, sizeof(int));
+    g->neighbours = NULL;
+    g->transmissionTimes = NULL;
+    g->capacity = 0;
     g->nV = nV;
     g->nE = 0;
-    
-    for (int i = 0; i < nV; i++) {
-        g->vertices[i].id = i;
-        g->vertices[i].securityLevel = malloc(sizeof(int));
-        g->vertices[i].poodleTime = malloc(sizeof(int));
+    g->out = (struct arcs){NULL, NULL, NULL};
+    g->in = (struct arcs){NULL, NULL, NULL};
+    g->changing = false;
+    g->isChanged = calloc(nV, sizeof(bool));
+    g->changed = malloc(nV * sizeof(int));
+    g->numChanged = 0;
+
+    if (g->offsets == NULL || (nV > 0 && (g->securityLevels == NULL || g->poodleTimes == NULL
+        || g->isChanged == NULL || g->changed == NULL))) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    compileArcs(g);
+
+    return g;
+}
+
+// Returns a new graph with nV vertices and the given computers and connections
+// in O(V + E)
+// If the same pair of computers is connected more than once, only the first
+// connection is kept
+Graph GraphBuild(int nV, struct computer computers[], struct connection connections[], int numConnections) {
+    Graph g = GraphNew(nV);
+
+    for (int v = 0; v < nV; v++) {
+        assert(computers[v].securityLevel >= 0 && computers[v].securityLevel <= MAX_SECURITY_LEVEL);
+        g->securityLevels[v] = computers[v].securityLevel;
+        g->poodleTimes[v] = computers[v].poodleTime;
+    }
+
+    for (int j = 0; j < numConnections; j++) {
+        assert(validVertex(g, connections[j].computerA));
+        assert(validVertex(g, connections[j].computerB));
+    }
+
+    bool *keep = firstConnections(nV, connections, numConnections);
+
+    // count the half-edges of every vertex, then prefix sum into row offsets
+    for (int j = 0; j < numConnections; j++) {
+        if (keep[j]) {
+            g->offsets[connections[j].computerA + 1]++;
+            g->offsets[connections[j].computerB + 1]++;
+            g->nE++;
+        }
+    }
+    for (int v = 0; v < nV; v++) {
+        g->offsets[v + 1] += g->offsets[v];
+    }
+
+    reserveHalfEdges(g, g->offsets[nV]);
+
+    int *rowEnd = malloc(nV * sizeof(int));
+    if (rowEnd == NULL && nV > 0) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+    for (int v = 0; v < nV; v++) {
+        rowEnd[v] = g->offsets[v];
+    }
+
+    for (int j = 0; j < numConnections; j++) {
+        if (keep[j]) {
+            int v = connections[j].computerA;
+            int w = connections[j].computerB;
+
+            g->neighbours[rowEnd[v]] = w;
+            g->transmissionTimes[rowEnd[v]++] = connections[j].transmissionTime;
+            g->neighbours[rowEnd[w]] = v;
+            g->transmissionTimes[rowEnd[w]++] = connections[j].transmissionTime;
+        }
     }
 
+    free(rowEnd);
+    free(keep);
+
+    compileArcs(g);
+
     return g;
 }
 
 // Frees all memory allocated to graph
 void GraphFree(Graph g) {
-    for (int i = 0; i < g->nV; i++) {
-		struct adjNode *curr = g->edges[i];
-		while (curr != NULL) {
-			struct adjNode *temp = curr;
-			curr = curr->next;
-			free(temp);
-		}
-        free(g->vertices[i].securityLevel);
-        free(g->vertices[i].poodleTime);
-	}
-
-	free(g->edges);
-    free(g->vertices);
+	free(g->offsets);
+	free(g->neighbours);
+	free(g->transmissionTimes);
+	free(g->securityLevels);
+	free(g->poodleTimes);
+	free(g->isChanged);
+	free(g->changed);
+	freeArcs(&g->out);
+	freeArcs(&g->in);
 	free(g);
 }
 
@@ -76,36 +198,25 @@ bool GraphIsAdjacent(Graph g, int v, int w) {
 	assert(validVertex(g, v));
 	assert(validVertex(g, w));
 
-    struct adjNode *curr = g->edges[v];
-    while (curr != NULL) {
-        if (curr->vertex.id == w) {
-            return true;
-        }
-        curr = curr->next;
-    }
-
-	return false;
+	return findHalfEdge(g, v, w) != -1;
 }
 
 // Inserts an edge between v and w
+// Shifts the adjacency arrays, so this is O(V + E); use GraphBuild to
+// construct a whole graph
 void GraphInsertEdge(Graph g, int v, int w, int transmissionTime) {
 	assert(validVertex(g, v));
 	assert(validVertex(g, w));
 
 	if (!GraphIsAdjacent(g, v, w)) {
-        struct adjNode *nodeV = malloc(sizeof(struct adjNode));
-        nodeV->vertex = g->vertices[w];
-        nodeV->transmissionTime = transmissionTime;
-        nodeV->next = g->edges[v];
-        g->edges[v] = nodeV;
-
-        struct adjNode *nodeW = malloc(sizeof(struct adjNode));
-        nodeW->vertex = g->vertices[v];
-        nodeW->transmissionTime = transmissionTime;
-        nodeW->next = g->edges[w];
-        g->edges[w] = nodeW;
-
+		insertHalfEdge(g, v, w, transmissionTime);
+		insertHalfEdge(g, w, v, transmissionTime);
 		g->nE++;
+		markChanged(g, v);
+		markChanged(g, w);
+		if (!g->changing) {
+			updateArcs(g);
+		}
 	}
 }
 
@@ -114,37 +225,33 @@ void GraphRemoveEdge(Graph g, int v, int w) {
 	assert(validVertex(g, v));
 	assert(validVertex(g, w));
 
-    struct adjNode *curr = g->edges[v];
-    struct adjNode *prev = NULL;
+	int index = findHalfEdge(g, v, w);
+	if (index == -1) {
+		return;
+	}
+	removeHalfEdge(g, v, index);
 
-    while (curr != NULL && curr->vertex.id != w) {
-        prev = curr;
-        curr = curr->next;
-    }
-    if (curr != NULL) {
-        if (prev == NULL) {
-            g->edges[v] = curr->next;
-        } else {
-            prev->next = curr->next;
-        }
-        free(curr);
-    }
+	index = findHalfEdge(g, w, v);
+	if (index != -1) {
+		removeHalfEdge(g, w, index);
+	}
+	g->nE--;
+	markChanged(g, v);
+	markChanged(g, w);
+	if (!g->changing) {
+		updateArcs(g);
+	}
+}
 
-    curr = g->edges[w];
-    prev = NULL;
-    while (curr != NULL && curr->vertex.id != v) {
-        prev = curr;
-        curr = curr->next;
-    }
-    if (curr != NULL) {
-        if (prev == NULL) {
-            g->edges[w] = curr->next;
-        } else {
-            prev->next = curr->next;
-        }
-        free(curr);
-    }
-    g->nE--;
+// Starts a batch of changes
+void GraphBeginChanges(Graph g) {
+    g->changing = true;
+}
+
+// Ends a batch of changes, rebuilding the arcs once for all of them
+void GraphEndChanges(Graph g) {
+    g->changing = false;
+    updateArcs(g);
 }
 
 // // Displays a graph
@@ -166,20 +273,31 @@ void GraphRemoveEdge(Graph g, int v, int w) {
 // Set the security level and poodle time for a vertex
 void GraphSetVertexInfo(Graph g, int v, int securityLevel, int poodleTime) {
     assert(validVertex(g, v));
-    *(g->vertices[v].securityLevel) = securityLevel;
-    *(g->vertices[v].poodleTime) = poodleTime;
+    assert(securityLevel >= 0 && securityLevel <= MAX_SECURITY_LEVEL);
+    g->securityLevels[v] = securityLevel;
+    g->poodleTimes[v] = poodleTime;
+
+    // the arcs between v and its neighbours both ways depend on its security level,
+    // and the ones into it on its poodle time
+    markChanged(g, v);
+    for (int i = g->offsets[v]; i < g->offsets[v + 1]; i++) {
+        markChanged(g, g->neighbours[i]);
+    }
+    if (!g->changing) {
+        updateArcs(g);
+    }
 }
 
 // Get the security level of a vertex
 int GraphGetSecurityLevel(Graph g, int v) {
     assert(validVertex(g, v));
-    return *(g->vertices[v].securityLevel);
+    return g->securityLevels[v];
 }
 
 // Get the poodle time of a vertex
 int GraphGetPoodleTime(Graph g, int v) {
     assert(validVertex(g, v));
-    return *(g->vertices[v].poodleTime);
+    return g->poodleTimes[v];
 }
 
 // Get the transmission time between vertices
@@ -187,15 +305,12 @@ int GraphGetTransmissionTime(Graph g, int v, int w) {
     assert(validVertex(g, v));
     assert(validVertex(g, w));
     
-    struct adjNode *curr = g->edges[v];
-    while (curr != NULL) {
-        if (curr->vertex.id == w) {
-            return curr->transmissionTime;
-        }
-        curr = curr->next;
+    int index = findHalfEdge(g, v, w);
+    if (index == -1) {
+        return -1;
     }
 
-    return -1;
+    return g->transmissionTimes[index];
 }
 
 // Checks if a vertex is valid
@@ -205,15 +320,8 @@ static bool validVertex(Graph g, int v) {
 
 // Gets the number of neighbours of a certain vertex
 int GraphNeighbourCount(Graph g, int v) {
-    int count = 0;
-    struct adjNode *curr = g->edges[v];
-    
-    while (curr != NULL) {
-        count++;
-        curr = curr->next;
-    }
-
-    return count;
+    assert(validVertex(g, v));
+    return g->offsets[v + 1] - g->offsets[v];
 }
 
 // Gets the neighborus of a vertex
@@ -221,17 +329,477 @@ int *GraphNeighbours(Graph g, int v) {
     int count = GraphNeighbourCount(g, v);
     int *adjacent = malloc(count * sizeof(int));
 
-    if (adjacent == NULL) {
+    if (adjacent == NULL && count > 0) {
         fprintf(stderr, "Error: Out of memory");
         exit(1);
     }
 
-    int i = 0;
-    struct adjNode *curr = g->edges[v];
-    while (curr != NULL) {
-        adjacent[i++] = curr->vertex.id;
-        curr = curr->next;
+    if (count > 0) {
+        memcpy(adjacent, &g->neighbours[g->offsets[v]], count * sizeof(int));
     }
 
     return adjacent;
 }
+
+// Gets the neighbours of a vertex and their transmission times
+// without allocating memory
+GraphNeighbourSpan GraphGetNeighbours(Graph g, int v) {
+    assert(validVertex(g, v));
+
+    GraphNeighbourSpan span = {0, NULL, NULL};
+    span.count = g->offsets[v + 1] - g->offsets[v];
+    if (span.count > 0) {
+        span.neighbours = &g->neighbours[g->offsets[v]];
+        span.transmissionTimes = &g->transmissionTimes[g->offsets[v]];
+    }
+
+    return span;
+}
+
+// Returns an array marking the first connection between each pair of
+// vertices. The connections are radix sorted by their (smaller, larger)
+// endpoints with two stable counting sorts, which leaves each group of
+// duplicates contiguous and in their original order.
+static bool *firstConnections(int nV, struct connection connections[], int numConnections) {
+    // the sizes are worked out in size_t, and checked, so that they can never wrap around. there is always
+    // room for at least one connection, so that no array is ever empty
+    size_t n = numConnections > 0 ? (size_t)numConnections : 1;
+    if (n > SIZE_MAX / sizeof(int)) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    int *order = malloc(n * sizeof(int));
+    int *sorted = malloc(n * sizeof(int));
+    int *low = malloc(n * sizeof(int));
+    int *high = malloc(n * sizeof(int));
+    bool *keep = malloc(n * sizeof(bool));
+
+    if ((order == NULL || sorted == NULL || low == NULL || high == NULL || keep == NULL)) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    for (int j = 0; j < numConnections; j++) {
+        int a = connections[j].computerA;
+        int b = connections[j].computerB;
+        low[j] = a < b ? a : b;
+        high[j] = a < b ? b : a;
+        order[j] = j;
+    }
+
+    countingSort(order, sorted, high, numConnections, nV);
+    countingSort(sorted, order, low, numConnections, nV);
+
+    for (int i = 0; i < numConnections; i++) {
+        int j = order[i];
+        int prev = i > 0 ? order[i - 1] : -1;
+        keep[j] = (prev == -1 || low[prev] != low[j] || high[prev] != high[j]);
+    }
+
+    free(order);
+    free(sorted);
+    free(low);
+    free(high);
+
+    return keep;
+}
+
+// Stably sorts the indices in order[] by keys[index] into sorted[]
+static void countingSort(int order[], int sorted[], int keys[], int n, int numKeys) {
+    int *start = calloc(numKeys + 1, sizeof(int));
+    if (start == NULL) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    for (int i = 0; i < n; i++) {
+        start[keys[order[i]] + 1]++;
+    }
+    for (int k = 0; k < numKeys; k++) {
+        start[k + 1] += start[k];
+    }
+    for (int i = 0; i < n; i++) {
+        sorted[start[keys[order[i]]]++] = order[i];
+    }
+
+    free(start);
+}
+
+// Gets the arcs from v to the computers it may send to
+GraphArcSpan GraphGetOutArcs(Graph g, int v) {
+    assert(validVertex(g, v));
+    return arcSpan(&g->out, v);
+}
+
+// Gets the arcs into v from the computers that may send to it
+GraphArcSpan GraphGetInArcs(Graph g, int v) {
+    assert(validVertex(g, v));
+    return arcSpan(&g->in, v);
+}
+
+// Returns the number of arcs in a graph
+int GraphNumArcs(Graph g) {
+    return g->out.offsets[g->nV];
+}
+
+// Returns the largest arc cost in a graph, or 0 if it has no arcs
+int GraphMaxArcCost(Graph g) {
+    return g->maxArcCost;
+}
+
+// Returns the index of the half-edge v -> w, or -1 if there is none
+static int findHalfEdge(Graph g, int v, int w) {
+    for (int i = g->offsets[v]; i < g->offsets[v + 1]; i++) {
+        if (g->neighbours[i] == w) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// Makes room for at least capacity half-edges
+static void reserveHalfEdges(Graph g, int capacity) {
+    if (capacity <= g->capacity) {
+        return;
+    }
+
+    g->neighbours = realloc(g->neighbours, capacity * sizeof(int));
+    g->transmissionTimes = realloc(g->transmissionTimes, capacity * sizeof(int));
+    if (g->neighbours == NULL || g->transmissionTimes == NULL) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    g->capacity = capacity;
+}
+
+// Appends the half-edge v -> w to the end of v's row
+static void insertHalfEdge(Graph g, int v, int w, int transmissionTime) {
+    int total = g->offsets[g->nV];
+    if (total == g->capacity) {
+        reserveHalfEdges(g, g->capacity == 0 ? 8 : 2 * g->capacity);
+    }
+
+    int index = g->offsets[v + 1];
+    memmove(&g->neighbours[index + 1], &g->neighbours[index], (total - index) * sizeof(int));
+    memmove(&g->transmissionTimes[index + 1], &g->transmissionTimes[index], (total - index) * sizeof(int));
+    g->neighbours[index] = w;
+    g->transmissionTimes[index] = transmissionTime;
+
+    for (int u = v + 1; u <= g->nV; u++) {
+        g->offsets[u]++;
+    }
+}
+
+// Removes the half-edge stored at index from v's row
+static void removeHalfEdge(Graph g, int v, int index) {
+    int total = g->offsets[g->nV];
+    memmove(&g->neighbours[index], &g->neighbours[index + 1], (total - index - 1) * sizeof(int));
+    memmove(&g->transmissionTimes[index], &g->transmissionTimes[index + 1], (total - index - 1) * sizeof(int));
+
+    for (int u = v + 1; u <= g->nV; u++) {
+        g->offsets[u]--;
+    }
+}
+
+// Rebuilds the out and in arc structures from the edges and vertex
+// attributes: two passes over the edges, one to count and one to fill
+static void compileArcs(Graph g) {
+    freeArcs(&g->out);
+    freeArcs(&g->in);
+
+    int nV = g->nV;
+    g->out.offsets = calloc(nV + 1, sizeof(int));
+    g->in.offsets = calloc(nV + 1, sizeof(int));
+    if (g->out.offsets == NULL || g->in.offsets == NULL) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    for (int v = 0; v < nV; v++) {
+        for (int i = g->offsets[v]; i < g->offsets[v + 1]; i++) {
+            int w = g->neighbours[i];
+            if (g->securityLevels[w] <= g->securityLevels[v] + 1) {
+                g->out.offsets[v + 1]++;
+                g->in.offsets[w + 1]++;
+            }
+        }
+    }
+    for (int v = 0; v < nV; v++) {
+        g->out.offsets[v + 1] += g->out.offsets[v];
+        g->in.offsets[v + 1] += g->in.offsets[v];
+    }
+
+    int numArcs = g->out.offsets[nV];
+    g->out.vertices = malloc(numArcs * sizeof(int));
+    g->out.costs = malloc(numArcs * sizeof(int));
+    g->in.vertices = malloc(numArcs * sizeof(int));
+    g->in.costs = malloc(numArcs * sizeof(int));
+    int *inEnd = malloc(nV * sizeof(int));
+    if ((numArcs > 0 && (g->out.vertices == NULL || g->out.costs == NULL || g->in.vertices == NULL
+        || g->in.costs == NULL)) || (nV > 0 && inEnd == NULL)) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    for (int v = 0; v < nV; v++) {
+        inEnd[v] = g->in.offsets[v];
+    }
+
+    g->maxArcCost = 0;
+    int k = 0;
+    for (int v = 0; v < nV; v++) {
+        for (int i = g->offsets[v]; i < g->offsets[v + 1]; i++) {
+            int w = g->neighbours[i];
+            if (g->securityLevels[w] <= g->securityLevels[v] + 1) {
+                long long cost = (long long)g->transmissionTimes[i] + g->poodleTimes[w];
+                int capped = cost > INT_MAX ? INT_MAX : cost;
+                if (capped > g->maxArcCost) {
+                    g->maxArcCost = capped;
+                }
+
+                g->out.vertices[k] = w;
+                g->out.costs[k++] = capped;
+                g->in.vertices[inEnd[w]] = v;
+                g->in.costs[inEnd[w]++] = capped;
+            }
+        }
+    }
+
+    free(inEnd);
+}
+
+// Marks v's rows of the arcs as out of date
+static void markChanged(Graph g, int v) {
+    if (!g->isChanged[v]) {
+        g->isChanged[v] = true;
+        g->changed[g->numChanged++] = v;
+    }
+}
+
+// Brings the arcs up to date with the changes since they were last built
+static void updateArcs(Graph g) {
+    int numChanged = g->numChanged;
+    if (numChanged == 0) {
+        return;
+    }
+
+    int *growth = malloc(numChanged * sizeof(int));
+    if (growth == NULL) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+
+    qsort(g->changed, numChanged, sizeof(int), compareInts);
+
+    // the largest cost only has to be found again if an arc that had it may be gone
+    bool lostMax = false;
+    for (int i = 0; i < numChanged; i++) {
+        GraphArcSpan row = arcSpan(&g->out, g->changed[i]);
+        for (int k = 0; k < row.count; k++) {
+            lostMax = lostMax || row.costs[k] == g->maxArcCost;
+        }
+    }
+
+    for (int i = 0; i < numChanged; i++) {
+        growth[i] = fillRow(g, g->changed[i], true, NULL, NULL) - arcSpan(&g->out, g->changed[i]).count;
+    }
+    patchArcs(g, &g->out, true, growth);
+    for (int i = 0; i < numChanged; i++) {
+        growth[i] = fillRow(g, g->changed[i], false, NULL, NULL) - arcSpan(&g->in, g->changed[i]).count;
+    }
+    patchArcs(g, &g->in, false, growth);
+
+    if (lostMax) {
+        g->maxArcCost = 0;
+        for (int k = 0; k < g->out.offsets[g->nV]; k++) {
+            if (g->out.costs[k] > g->maxArcCost) {
+                g->maxArcCost = g->out.costs[k];
+            }
+        }
+    } else {
+        for (int i = 0; i < numChanged; i++) {
+            GraphArcSpan row = arcSpan(&g->out, g->changed[i]);
+            for (int k = 0; k < row.count; k++) {
+                if (row.costs[k] > g->maxArcCost) {
+                    g->maxArcCost = row.costs[k];
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < numChanged; i++) {
+        g->isChanged[g->changed[i]] = false;
+    }
+    g->numChanged = 0;
+    free(growth);
+}
+
+// Rebuilds an arc structure (out if out, else in) in place, where the
+// row of changed vertex i (in ascending order) gains growth[i] arcs.
+// The run of rows between two changed vertices shifts by however many arcs
+// the changed rows before it have gained or lost. Runs that move towards
+// the front are moved front to back and the rest back to front, so that no
+// run is overwritten before it has moved. The changed rows are then filled
+// in afresh, in the gaps left between the runs
+static void patchArcs(Graph g, struct arcs *a, bool out, int growth[]) {
+    int nV = g->nV;
+    int numChanged = g->numChanged;
+    int *changed = g->changed;
+
+    int oldTotal = a->offsets[nV];
+    int newTotal = oldTotal;
+    for (int i = 0; i < numChanged; i++) {
+        newTotal += growth[i];
+    }
+    if (newTotal > oldTotal) {
+        reserveArcs(a, newTotal);
+    }
+
+    // the run after changed vertex i starts at the end of its row, and ends
+    // at the start of the next one's
+    int shift = 0;
+    for (int i = 0; i < numChanged; i++) {
+        int v = changed[i];
+        shift += growth[i];
+        if (shift <= 0) {
+            int end = i + 1 < numChanged ? a->offsets[changed[i + 1]] : oldTotal;
+            moveRun(a, a->offsets[v + 1], a->offsets[v + 1] + shift, end - a->offsets[v + 1]);
+        }
+    }
+    for (int i = numChanged - 1; i >= 0; i--) {
+        int v = changed[i];
+        if (shift > 0) {
+            int end = i + 1 < numChanged ? a->offsets[changed[i + 1]] : oldTotal;
+            moveRun(a, a->offsets[v + 1], a->offsets[v + 1] + shift, end - a->offsets[v + 1]);
+        }
+        shift -= growth[i];
+    }
+
+    // shift every offset after the first changed row, then fill the rows in
+    shift = 0;
+    for (int i = 0; i < numChanged; i++) {
+        int v = changed[i];
+        int end = i + 1 < numChanged ? changed[i + 1] : nV;
+        shift += growth[i];
+        for (int u = v + 1; u <= end; u++) {
+            a->offsets[u] += shift;
+        }
+    }
+    for (int i = 0; i < numChanged; i++) {
+        int v = changed[i];
+        fillRow(g, v, out, &a->vertices[a->offsets[v]], &a->costs[a->offsets[v]]);
+    }
+
+    if (newTotal < oldTotal) {
+        reserveArcs(a, newTotal);
+    }
+}
+
+// Moves count arcs of an arc structure from index from to index to
+static void moveRun(struct arcs *a, int from, int to, int count) {
+    if (count > 0 && from != to) {
+        memmove(&a->vertices[to], &a->vertices[from], count * sizeof(int));
+        memmove(&a->costs[to], &a->costs[from], count * sizeof(int));
+    }
+}
+
+// Resizes the arrays of an arc structure to hold numArcs arcs
+static void reserveArcs(struct arcs *a, int numArcs) {
+    int size = numArcs > 0 ? numArcs : 1;
+    a->vertices = realloc(a->vertices, size * sizeof(int));
+    a->costs = realloc(a->costs, size * sizeof(int));
+    if (a->vertices == NULL || a->costs == NULL) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+}
+
+// Compares ints for qsort
+static int compareInts(const void *a, const void *b) {
+    int x = *(int *)a;
+    int y = *(int *)b;
+
+    return (x > y) - (x < y);
+}
+
+// Writes v's row of the out arcs (or the in arcs, if not out) to vertices[]
+// and costs[], unless they are NULL. Since every edge is two half-edges,
+// both rows come from v's neighbours. The in row is sorted by sender, as
+// compileArcs lays it out, so a row is the same whether the graph was built
+// or changed. Returns the number of arcs in the row
+static int fillRow(Graph g, int v, bool out, int vertices[], int costs[]) {
+    int count = 0;
+    for (int i = g->offsets[v]; i < g->offsets[v + 1]; i++) {
+        int w = g->neighbours[i];
+        int from = out ? v : w;
+        int to = out ? w : v;
+
+        if (g->securityLevels[to] <= g->securityLevels[from] + 1) {
+            if (vertices != NULL) {
+                long long cost = (long long)g->transmissionTimes[i] + g->poodleTimes[to];
+                vertices[count] = w;
+                costs[count] = cost > INT_MAX ? INT_MAX : cost;
+            }
+            count++;
+        }
+    }
+    if (!out && vertices != NULL) {
+        sortRow(vertices, costs, count);
+    }
+
+    return count;
+}
+
+// Sorts a row of count arcs by vertex, keeping each cost with its vertex
+static void sortRow(int vertices[], int costs[], int count) {
+    if (count < 2) {
+        return;
+    }
+
+    struct arc *row = malloc(count * sizeof(struct arc));
+    if (row == NULL) {
+        fprintf(stderr, "Error: Out of memory");
+        exit(1);
+    }
+    for (int i = 0; i < count; i++) {
+        row[i] = (struct arc){vertices[i], costs[i]};
+    }
+    qsort(row, count, sizeof(struct arc), compareArcs);
+    for (int i = 0; i < count; i++) {
+        vertices[i] = row[i].vertex;
+        costs[i] = row[i].cost;
+    }
+
+    free(row);
+}
+
+// Compares arcs by vertex for qsort
+static int compareArcs(const void *a, const void *b) {
+    int x = ((struct arc *)a)->vertex;
+    int y = ((struct arc *)b)->vertex;
+
+    return (x > y) - (x < y);
+}
+
+// Frees the arrays of an arc structure
+static void freeArcs(struct arcs *a) {
+    free(a->offsets);
+    free(a->vertices);
+    free(a->costs);
+    *a = (struct arcs){NULL, NULL, NULL};
+}
+
+// Gets the row of v in an arc structure
+static GraphArcSpan arcSpan(struct arcs *a, int v) {
+    GraphArcSpan span = {0, NULL, NULL};
+    span.count = a->offsets[v + 1] - a->offsets[v];
+    if (span.count > 0) {
+        span.vertices = &a->vertices[a->offsets[v]];
+        span.costs = &a->costs[a->offsets[v]];
+    }
+
+    return span;
+}
@@ -7,17 +7,18 @@
 
 #include <stdbool.h>
 
-typedef struct graph *Graph;
+#include "poodle.h"
 
-typedef struct Vertex {
-    int id;
-    int *securityLevel;
-    int *poodleTime;
-} Vertex;
+typedef struct graph *Graph;
 
 // Returns a new graph with nV vertices
 Graph GraphNew(int nV);
 
+// Returns a new graph with nV vertices and the given computers and
+// connections in O(V + E)
+// Duplicate connections between the same pair of vertices keep the first one
+Graph GraphBuild(int nV, struct computer computers[], struct connection connections[], int numConnections);
+
 // Frees all memory allocated to a graph
 void GraphFree(Graph g);
 
@@ -31,11 +32,23 @@ int GraphNumEdges(Graph g);
 bool GraphIsAdjacent(Graph g, int v, int w);
 
 // Adds an edge beteeen v and w
+// This and the other functions that modify a graph are O(V + E)
 void GraphInsertEdge(Graph g, int v, int w, int transmissionTime);
 
-// Removes an edge between v and w
+// Removes an edge between v and w, if there is one
 void GraphRemoveEdge(Graph g, int v, int w);
 
+// Starts a batch of changes: until GraphEndChanges, the functions above
+// and GraphSetVertexInfo only change the edges and vertices, leaving the
+// arcs (see below) as they were before the batch
+void GraphBeginChanges(Graph g);
+
+// Ends a batch of changes, bringing the arcs up to date once for all of
+// them. Only the arcs of the vertices that were changed (or are neighbours
+// of a vertex given new info) are worked out again, and the rest moved
+// along in place, so this is O(V + E) but far cheaper than building the graph again
+void GraphEndChanges(Graph g);
+
 // Displays a graph
 // void GraphShow(Graph g);
 
@@ -57,5 +70,46 @@ int GraphNeighbourCount(Graph g, int v);
 // Gets the neighborus of a vertex
 int *GraphNeighbours(Graph g, int v);
 
+// A read-only view of the neighbours of a vertex without copying them:
+// neighbours[i] is connected by an edge with transmission time
+// transmissionTimes[i]. The view is invalidated when the graph is modified.
+typedef struct GraphNeighbourSpan {
+    int count;
+    const int *neighbours;
+    const int *transmissionTimes;
+} GraphNeighbourSpan;
+
+// Gets the neighbours of a vertex and their transmission times
+// without allocating memory
+GraphNeighbourSpan GraphGetNeighbours(Graph g, int v);
+
+// The graph also keeps a compiled copy of its directed "may send to" arcs:
+// v -> w is an arc if v and w are connected and w's security level is at
+// most one more than v's. An arc costs its transmission time plus the poodle
+// time of the computer receiving it (w), capped at INT_MAX, which is the
+// time it adds to a poodling plan.
+
+// A read-only view of the arcs out of or into a vertex: vertices[i] is the
+// other end of arc i, which costs costs[i]. The view is invalidated when
+// the graph is modified.
+typedef struct GraphArcSpan {
+    int count;
+    const int *vertices;
+    const int *costs;
+} GraphArcSpan;
+
+// Gets the arcs from v to the computers it may send to
+GraphArcSpan GraphGetOutArcs(Graph g, int v);
+
+// Gets the arcs into v from the computers that may send to it, in
+// ascending order of sender
+GraphArcSpan GraphGetInArcs(Graph g, int v);
+
+// Returns the number of arcs in a graph
+int GraphNumArcs(Graph g);
+
+// Returns the largest arc cost in a graph, or 0 if it has no arcs
+int GraphMaxArcCost(Graph g);
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #endif
\ No newline at end of file
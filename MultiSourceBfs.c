@@ -0,0 +1,158 @@
+// Multi-source bit-parallel BFS (MS-BFS)
+// Based on "The More the Merrier: Efficient Multi-Source Graph Traversal"
+// (Then et al., VLDB 2014)
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MultiSourceBfs.h"
+
+#define WORD_BITS 64
+
+// Bit i of a vertex's mask stands for source i. seen[] holds every source
+// that has reached the vertex, visit[] the sources that reached it in the
+// current level and visitNext[] those reaching it in the next one. Only
+// vertices on the frontier lists have non-zero visit/visitNext masks.
+struct msBfs {
+    Graph g;
+    int numWords;
+    uint64_t *seen;
+    uint64_t *visit;
+    uint64_t *visitNext;
+    int *frontier;
+    int *nextFrontier;
+};
+
+static uint64_t *newMasks(int numVert, int numWords);
+
+MsBfs MsBfsNew(Graph g, int maxSources) {
+    assert(maxSources >= 1 && maxSources <= MSBFS_MAX_SOURCES);
+
+    MsBfs bfs = malloc(sizeof(struct msBfs));
+    if (bfs == NULL) {
+        fprintf(stderr, "error: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int numVert = GraphNumVertices(g);
+    bfs->g = g;
+    bfs->numWords = (maxSources + WORD_BITS - 1) / WORD_BITS;
+    bfs->seen = newMasks(numVert, bfs->numWords);
+    bfs->visit = newMasks(numVert, bfs->numWords);
+    bfs->visitNext = newMasks(numVert, bfs->numWords);
+    bfs->frontier = malloc(numVert * sizeof(int));
+    bfs->nextFrontier = malloc(numVert * sizeof(int));
+
+    if (numVert > 0 && (bfs->frontier == NULL || bfs->nextFrontier == NULL)) {
+        fprintf(stderr, "error: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return bfs;
+}
+
+void MsBfsFree(MsBfs bfs) {
+    free(bfs->seen);
+    free(bfs->visit);
+    free(bfs->visitNext);
+    free(bfs->frontier);
+    free(bfs->nextFrontier);
+    free(bfs);
+}
+
+void MsBfsRun(MsBfs bfs, int sources[], int numSources, int counts[]) {
+    assert(numSources <= bfs->numWords * WORD_BITS);
+
+    Graph g = bfs->g;
+    int numWords = bfs->numWords;
+    int numVert = GraphNumVertices(g);
+
+    memset(bfs->seen, 0, (size_t)numVert * numWords * sizeof(uint64_t));
+
+    int frontierSize = 0;
+    for (int i = 0; i < numSources; i++) {
+        int s = sources[i];
+        uint64_t *visit = &bfs->visit[(size_t)s * numWords];
+
+        bool empty = true;
+        for (int k = 0; k < numWords; k++) {
+            empty = empty && visit[k] == 0;
+        }
+        if (empty) {
+            bfs->frontier[frontierSize++] = s;
+        }
+
+        visit[i / WORD_BITS] |= (uint64_t)1 << (i % WORD_BITS);
+        bfs->seen[(size_t)s * numWords + i / WORD_BITS] |= (uint64_t)1 << (i % WORD_BITS);
+        counts[i] = 1;
+    }
+
+    while (frontierSize > 0) {
+        int nextSize = 0;
+
+        for (int f = 0; f < frontierSize; f++) {
+            int v = bfs->frontier[f];
+            uint64_t *visit = &bfs->visit[(size_t)v * numWords];
+            GraphArcSpan arcs = GraphGetOutArcs(g, v);
+
+            for (int i = 0; i < arcs.count; i++) {
+                int w = arcs.vertices[i];
+                uint64_t *seen = &bfs->seen[(size_t)w * numWords];
+                uint64_t *visitNext = &bfs->visitNext[(size_t)w * numWords];
+                bool wasEmpty = true;
+                bool reached = false;
+
+                for (int k = 0; k < numWords; k++) {
+                    uint64_t newSources = visit[k] & ~seen[k];
+                    wasEmpty = wasEmpty && visitNext[k] == 0;
+
+                    if (newSources != 0) {
+                        reached = true;
+                        visitNext[k] |= newSources;
+                        seen[k] |= newSources;
+
+                        while (newSources != 0) {
+                            counts[k * WORD_BITS + __builtin_ctzll(newSources)]++;
+                            newSources &= newSources - 1;
+                        }
+                    }
+                }
+
+                if (reached && wasEmpty) {
+                    bfs->nextFrontier[nextSize++] = w;
+                }
+            }
+        }
+
+        // the current level is done: clear its masks and move on to the next one
+        for (int f = 0; f < frontierSize; f++) {
+            memset(&bfs->visit[(size_t)bfs->frontier[f] * numWords], 0, numWords * sizeof(uint64_t));
+        }
+
+        uint64_t *masks = bfs->visit;
+        bfs->visit = bfs->visitNext;
+        bfs->visitNext = masks;
+
+        int *list = bfs->frontier;
+        bfs->frontier = bfs->nextFrontier;
+        bfs->nextFrontier = list;
+        frontierSize = nextSize;
+    }
+}
+
+//////////////////////////////////////////////////////////
+
+// helper function to allocate numWords zeroed masks for every vertex
+static uint64_t *newMasks(int numVert, int numWords) {
+    uint64_t *masks = calloc((size_t)numVert * numWords, sizeof(uint64_t));
+    if (masks == NULL && numVert > 0) {
+        fprintf(stderr, "error: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return masks;
+}
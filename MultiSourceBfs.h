@@ -0,0 +1,27 @@
+// Multi-source bit-parallel BFS (MS-BFS)
+// Explores the directed "may send to" graph from many sources at once: every
+// vertex carries a bitmask with one bit per source, so each arc is scanned
+// once per level for the whole batch instead of once per source.
+
+#ifndef MULTI_SOURCE_BFS_H
+#define MULTI_SOURCE_BFS_H
+
+#include "Graph.h"
+
+// The most sources a single run can explore (4 words of 64 bits per vertex)
+#define MSBFS_MAX_SOURCES 256
+
+typedef struct msBfs *MsBfs;
+
+// Creates a BFS engine for g able to run up to maxSources sources at once
+// Assumes 1 <= maxSources <= MSBFS_MAX_SOURCES
+MsBfs MsBfsNew(Graph g, int maxSources);
+
+// Frees all memory allocated to a BFS engine
+void MsBfsFree(MsBfs bfs);
+
+// Explores from every computer in sources[] at once, setting counts[i] to the
+// number of computers (including itself) that sources[i] can reach
+void MsBfsRun(MsBfs bfs, int sources[], int numSources, int counts[]);
+
+#endif
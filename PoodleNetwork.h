@@ -0,0 +1,254 @@
+// PoodleNetwork.h
+// A network handle that is built once from computers[] and connections[]
+// and can then answer any number of task 1-4 queries without rebuilding
+// its graph. The functions in poodle.h are wrappers around these.
+
+#ifndef POODLE_NETWORK_H
+#define POODLE_NETWORK_H
+
+#include "poodle.h"
+
+typedef struct poodleNetwork *PoodleNetwork;
+
+// The priority queue that task 3's shortest path search settles computers
+// with. Every engine produces the same plan
+typedef enum engine {
+	ENGINE_AUTO,		// a bucket queue when the times are small next to the number of computers, else a heap
+	ENGINE_HEAP,		// an indexed d-ary heap
+	ENGINE_BUCKET,		// a bucket queue, falling back to the heap if the times are too large
+	ENGINE_PARALLEL,	// multithreaded delta-stepping (see PoodleNetworkSetThreads)
+} Engine;
+
+// Builds a network from its computers and connections
+// The arrays are copied, so they may be freed once this returns
+PoodleNetwork PoodleNetworkNew(
+	struct computer computers[], int numComputers,
+	struct connection connections[], int numConnections
+);
+
+// Frees all memory allocated to a network
+void PoodleNetworkFree(PoodleNetwork net);
+
+// Returns the number of computers in a network
+int PoodleNetworkNumComputers(PoodleNetwork net);
+
+// Chooses the priority queue engine used by later task 3 queries
+// Networks start with ENGINE_AUTO
+void PoodleNetworkSetEngine(PoodleNetwork net, Engine engine);
+
+// Sets how many threads parallel queries may use, or 0 (the default) to use
+// one per online processor
+void PoodleNetworkSetThreads(PoodleNetwork net, int numThreads);
+
+// Task 1 on an existing network
+struct probePathResult PoodleNetworkProbePath(
+	PoodleNetwork net, int path[], int pathLength
+);
+
+// Task 2 on an existing network. The first call builds an index of the
+// network's strongly connected components and how many computers each
+// source component reaches, which PoodleNetworkApplyChanges keeps up to
+// date, so later calls only count again what the changes since have
+// affected
+struct chooseSourceResult PoodleNetworkChooseSource(PoodleNetwork net);
+
+// Returns the number of computers (including itself) that source can send
+// the pug to, directly or indirectly. If reachable is not NULL, they are
+// written to it in ascending order
+int PoodleNetworkReachable(PoodleNetwork net, int source, int reachable[]);
+
+// Sets counts[i] to the number of computers (including itself) that
+// sources[i] can send the pug to, directly or indirectly. The sources
+// are explored in bit-parallel batches, sharing each edge scan
+void PoodleNetworkReachableCounts(
+	PoodleNetwork net, int sources[], int numSources, int counts[]
+);
+
+// Task 3 on an existing network
+struct poodleResult PoodleNetworkPoodle(PoodleNetwork net, int sourceComputer);
+
+// Task 3 on an existing network, stopping before the first computer that
+// would be poodled after deadline, or once maxSteps computers have been
+// poodled. Pass INFINITY or the number of computers to leave either
+// unbounded. The result is the start of the full plan, with each recipient
+// list cut down to the computers in it. Only the part of the network that
+// the search reaches is visited, so a tight bound costs far less than a
+// full query. Bounded queries always search on one thread
+struct poodleResult PoodleNetworkPoodleBounded(
+	PoodleNetwork net, int sourceComputer, int deadline, int maxSteps
+);
+
+// Task 3 on an existing network, with the steps and all of the recipient
+// nodes in one allocation, so the result is freed with just free(res.steps)
+struct poodleResult PoodleNetworkPoodlePacked(
+	PoodleNetwork net, int sourceComputer
+);
+
+// A task 3 plan as flat arrays. Step i poodles computers[i], finishing at
+// times[i], and sends the pug to recipients[offsets[i]] up to (but not
+// including) recipients[offsets[i + 1]], in ascending order
+struct poodlePlan {
+	int numSteps;
+	int *computers;
+	int *times;
+	int *offsets;		// numSteps + 1 entries
+	int *recipients;
+};
+
+// Task 3 on an existing network, as a flat plan
+struct poodlePlan PoodleNetworkPoodlePlan(PoodleNetwork net, int sourceComputer);
+
+// Frees a flat plan. All of its arrays share one allocation
+void PoodlePlanFree(struct poodlePlan plan);
+
+// Task 3 with several computers poodled from the start: each source is
+// poodled at its own poodle time (unless the pug reaches it sooner from
+// another source), and everything else as soon as the pug can reach it
+// from any of them. Gives one merged plan from a single search, in the
+// same form as PoodleNetworkPoodle's. Repeated sources are ignored.
+// Multi-source searches always run on one thread
+struct poodleResult PoodleNetworkPoodleMultiSource(
+	PoodleNetwork net, int sources[], int numSources
+);
+
+// Task 3 from each of sources[0 .. numSources - 1] on an existing network,
+// setting results[i] to the plan for sources[i], exactly as
+// PoodleNetworkPoodle would. The searches are shared between the threads
+// set by PoodleNetworkSetThreads, each with its own workspace, and every
+// search runs on one thread
+void PoodleNetworkPoodleBatch(
+	PoodleNetwork net, int sources[], int numSources, struct poodleResult results[]
+);
+
+// What a task 3 plan comes to, without the plan itself
+struct poodleSummary {
+	int numSteps;			// the number of computers poodled
+	int completionTime;		// the time the last of them is poodled, or 0 if none is
+};
+
+// Like PoodleNetworkPoodleBatch, but only sets summaries[i] to the summary
+// of the plan for sources[i], which saves laying the plans out
+void PoodleNetworkPoodleSummaries(
+	PoodleNetwork net, int sources[], int numSources, struct poodleSummary summaries[]
+);
+
+// The source whose task 3 plan finishes first, out of those that reach
+// the most computers (the sources task 2 chooses between)
+struct fastestSourceResult {
+	int sourceComputer;		// the lowest numbered on ties, or -1 if there are no computers
+	int numComputers;		// the number of computers it reaches
+	int makespan;			// the time its last computer is poodled, or INFINITY if one never is
+};
+
+// Finds the fastest source without a full search from every candidate.
+// Candidates are searched in order of a lower bound on their makespan,
+// each search stopping as soon as it falls behind the best so far, and
+// every search tightens the bounds of the candidates it reaches: since
+// they all reach the same computers, a candidate x that c reaches at time
+// t can finish no sooner than c's makespan less t, plus x's poodle time
+struct fastestSourceResult PoodleNetworkFastestSource(PoodleNetwork net);
+
+// Called with each step of a streamed task 3 plan. The step's recipient
+// list belongs to the stream and is only valid until the callback returns
+typedef void (*PoodleStepCallback)(struct step step, void *context);
+
+// Task 3 on an existing network, handing each step to callback as soon as
+// its recipients are known instead of returning the whole plan. The steps
+// arrive in the same order as in PoodleNetworkPoodle's plan. Streams always
+// search on one thread, so ENGINE_PARALLEL is treated as ENGINE_AUTO
+void PoodleNetworkPoodleStream(
+	PoodleNetwork net, int sourceComputer,
+	PoodleStepCallback callback, void *context
+);
+
+// Returns the time computer is poodled at when sourceComputer is poodled
+// first, as in PoodleNetworkPoodle's plan, or INFINITY if it never is.
+// Rather than solving the whole network this runs a search out from the
+// source and one back from the computer until they meet, guided by
+// distances to and from a few landmark computers. The landmarks are found
+// by the first query, which takes about as long as a few full plans
+int PoodleNetworkPoodleTime(PoodleNetwork net, int sourceComputer, int computer);
+
+// Builds a contraction hierarchy over the network, after which
+// PoodleNetworkPoodleTime answers from it instead of the landmarks. Building
+// it takes many times longer than a full plan, but each query afterwards
+// only looks at a small part of the network. This pays off for networks
+// with some structure to them, where most connections are local (a few
+// hundred times faster than a full plan on a grid); random networks have
+// no such structure and are better left to the landmarks. Does nothing if
+// the hierarchy has already been built
+void PoodleNetworkPrepareHierarchy(PoodleNetwork net);
+
+// The kinds of change PoodleNetworkApplyChanges makes
+typedef enum changeKind {
+	CHANGE_ADD_CONNECTION,		// connects the connection's computers, unless they already are
+	CHANGE_REMOVE_CONNECTION,	// disconnects the connection's computers, if they are connected
+	CHANGE_SET_COMPUTER,		// gives computer a new security level and poodle time
+} ChangeKind;
+
+// One change to a network
+struct networkChange {
+	ChangeKind kind;
+	struct connection connection;	// for CHANGE_ADD_CONNECTION and CHANGE_REMOVE_CONNECTION
+	int computer;					// for CHANGE_SET_COMPUTER
+	struct computer info;			// likewise
+};
+
+// Makes a batch of changes to a network, in order. The network is rebuilt
+// once for the whole batch rather than once per change, and the tracked
+// plan (see PoodleNetworkTrack) and the task 2 index are brought up to date. The landmarks and
+// contraction hierarchy belong to the network as it was, so they are
+// dropped, and PoodleNetworkPrepareHierarchy has to be called again. To
+// change a connection's transmission time, remove it and add it back in
+// the same batch. Must not be called while other queries on the network
+// are running
+void PoodleNetworkApplyChanges(
+	PoodleNetwork net, struct networkChange changes[], int numChanges
+);
+
+// Starts keeping the task 3 plan from sourceComputer up to date as the
+// network changes, or stops if sourceComputer is -1. This costs one full
+// search. Afterwards, each batch of changes only searches the part of the
+// network whose times it changes: the computers whose shortest paths run
+// through a removed or slower arc are found by following the shortest
+// path dag out of it, and only they and the computers a faster arc
+// improves are searched again
+void PoodleNetworkTrack(PoodleNetwork net, int sourceComputer);
+
+// Returns the tracked plan, exactly as PoodleNetworkPoodle would give it
+// for the network as it is now
+struct poodleResult PoodleNetworkTrackedPoodle(PoodleNetwork net);
+
+// Returns the time computer is poodled at in the tracked plan, or INFINITY
+// if it never is
+int PoodleNetworkTrackedTime(PoodleNetwork net, int computer);
+
+// What losing one connection would do to the task 3 plan from a source
+struct linkImpact {
+	struct connection connection;	// with computerA < computerB
+	int makespan;			// the time the last computer still reached is poodled
+	int makespanDelta;		// makespan less the makespan with the connection
+	int reachedDelta;		// the change in the number of computers poodled (never positive)
+};
+
+// Lists the connections whose loss on its own would change when the task
+// 3 plan from sourceComputer finishes, or how many computers it poodles,
+// and sets *numLinks to how many there are. The ones that cut off the
+// most computers come first, then those that delay the plan most, then
+// the lowest numbered. The list is freed with free. Rather than searching
+// again without each connection, this runs one search, and only looks at
+// connections that carry a computer's only strictly earlier sender in its
+// shortest path dag. For each of them, the computers that lose their
+// times are found by following the dag out from it, and only they are
+// searched again. The connections are shared between the threads set by
+// PoodleNetworkSetThreads
+struct linkImpact *PoodleNetworkCriticalLinks(
+	PoodleNetwork net, int sourceComputer, int *numLinks
+);
+
+// Task 4 on an existing network
+struct poodleResult PoodleNetworkAdvancedPoodle(
+	PoodleNetwork net, int sourceComputer
+);
+
+#endif
@@ -1,6 +1,7 @@
 // Acknowledgements
 // - PriorityQueue ADT was taken from PqArray.c from lectures
 // was modified to handle structures in stage 3
+// was modified to be an indexed d-ary heap in stage 3
 
 #include <assert.h>
 #include <stdbool.h>
@@ -11,65 +12,89 @@
 
 #define INITIAL_CAPACITY 8
 
+// Number of children of each heap node. A wider heap is shallower, so
+// sifting up (every update) is cheaper and the children compared when
+// sifting down sit next to each other in memory
+#ifndef PQ_ARITY
+#define PQ_ARITY 4
+#endif
+
+// The heap is stored as two parallel arrays: items[i] has priority
+// priorities[i], and the children of slot i are slots PQ_ARITY * i + 1 to
+// PQ_ARITY * i + PQ_ARITY. positions[item] is the slot of an item, or -1
+// if it is not in the queue.
 struct pq {
-	struct pqItem *items;
-    int *positions;
+	int *items;
+	int *priorities;
 	int numItems;
 	int capacity;
-};
-
-struct pqItem {
-	int item;
-	int priority;
+	int *positions;
+	int numPositions;
 };
 
 static void resize(Pq pq);
+static void reservePositions(Pq pq, int item);
 static void heapifyUp(Pq pq, int index);
 static void heapifyDown(Pq pq, int index);
-static void swap(Pq pq, int i, int j);
 
 Pq PqNew(void) {
+	return PqNewWithCapacity(INITIAL_CAPACITY);
+}
+
+Pq PqNewWithCapacity(int capacity) {
 	Pq pq = malloc(sizeof(struct pq));
 	if (pq == NULL) {
 		fprintf(stderr, "error: out of memory\n");
 		exit(EXIT_FAILURE);
 	}
 
-	pq->numItems = 0;
-	pq->capacity = INITIAL_CAPACITY;
-	pq->items = malloc(pq->capacity * sizeof(struct pqItem));
-    pq->positions = malloc(pq->capacity * sizeof(int));
+	if (capacity < 1) {
+		capacity = 1;
+	}
 
-    if (pq->items == NULL || pq->positions == NULL) {
-        fprintf(stderr, "Error: Out of memory");
-        exit(EXIT_FAILURE);
-    }
+	pq->numItems = 0;
+	pq->capacity = capacity;
+	pq->items = malloc(pq->capacity * sizeof(int));
+	pq->priorities = malloc(pq->capacity * sizeof(int));
+	pq->numPositions = capacity;
+	pq->positions = malloc(pq->numPositions * sizeof(int));
+
+	if (pq->items == NULL || pq->priorities == NULL || pq->positions == NULL) {
+		fprintf(stderr, "Error: Out of memory");
+		exit(EXIT_FAILURE);
+	}
 
-    for (int i = 0; i < pq->capacity; i++) {
-        pq->positions[i] = -1;
-    }
+	for (int i = 0; i < pq->numPositions; i++) {
+		pq->positions[i] = -1;
+	}
 
 	return pq;
 }
 
 void PqFree(Pq pq) {
 	free(pq->items);
-    free(pq->positions);
+	free(pq->priorities);
+	free(pq->positions);
 	free(pq);
 }
 
 void PqInsert(Pq pq, int item, int priority) {
+	assert(item >= 0);
+	assert(!PqContains(pq, item));
+
 	if (pq->numItems == pq->capacity) {
 		resize(pq);
 	}
+	if (item >= pq->numPositions) {
+		reservePositions(pq, item);
+	}
 
-	pq->items[pq->numItems].item = item;
-	pq->items[pq->numItems].priority = priority;
-    pq->positions[item] = pq->numItems;
-
-    heapifyUp(pq, pq->numItems);
+	pq->items[pq->numItems] = item;
+	pq->priorities[pq->numItems] = priority;
+	pq->positions[item] = pq->numItems;
 
 	pq->numItems++;
+	heapifyUp(pq, pq->numItems - 1);
 }
 
 int PqSize(Pq pq) {
@@ -82,26 +107,34 @@ int PqDelete(Pq pq) {
 		exit(EXIT_FAILURE);
 	}
 
-    int item = pq->items[0].item;
-
-    pq->numItems--;
-    pq->items[0] = pq->items[pq->numItems];
-    pq->positions[pq->items[0].item] = 0;
+	int item = pq->items[0];
+	pq->positions[item] = -1;
 
-    heapifyDown(pq, 0);
+	pq->numItems--;
+	if (pq->numItems > 0) {
+		pq->items[0] = pq->items[pq->numItems];
+		pq->priorities[0] = pq->priorities[pq->numItems];
+		pq->positions[pq->items[0]] = 0;
+		heapifyDown(pq, 0);
+	}
 
 	return item;
 }
 
 void PqUpdate(Pq pq, int item, int priority) {
-    int index = pq->positions[item];
+    int index = item < pq->numPositions ? pq->positions[item] : -1;
     if (index == -1) {
         fprintf(stderr, "Error: item not found in priority queue");
         exit(EXIT_FAILURE);
     }
 
-    pq->items[index].priority = priority;
-    heapifyUp(pq, index);
+    if (priority < pq->priorities[index]) {
+        pq->priorities[index] = priority;
+        heapifyUp(pq, index);
+    } else {
+        pq->priorities[index] = priority;
+        heapifyDown(pq, index);
+    }
 }
 
 int PqPeek(Pq pq) {
@@ -110,65 +143,108 @@ int PqPeek(Pq pq) {
 		exit(EXIT_FAILURE);
 	}
 
-	return pq->items[0].item;
+	return pq->items[0];
+}
+
+bool PqContains(Pq pq, int item) {
+	return item >= 0 && item < pq->numPositions && pq->positions[item] != -1;
+}
+
+int PqPeekPriority(Pq pq) {
+	if (pq->numItems == 0) {
+		fprintf(stderr, "error: pq is empty\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return pq->priorities[0];
 }
 
 //////////////////////////////////////////////////////////
 
 // helper function to resize the priority queue
 static void resize(Pq pq) {
-    int oldCapacity = pq->capacity;
 	pq->capacity *= 2;
-	pq->items = realloc(pq->items, pq->capacity * sizeof(struct pqItem));
-    pq->positions = realloc(pq->positions, pq->capacity * sizeof(int));
+	pq->items = realloc(pq->items, pq->capacity * sizeof(int));
+	pq->priorities = realloc(pq->priorities, pq->capacity * sizeof(int));
 	
-    if (pq->items == NULL || pq->positions == NULL) {
+    if (pq->items == NULL || pq->priorities == NULL) {
 		fprintf(stderr, "error: out of memory\n");
 		exit(EXIT_FAILURE);
 	}
+}
+
+// helper function to grow the positions array so that it covers item
+static void reservePositions(Pq pq, int item) {
+    int oldSize = pq->numPositions;
+    while (pq->numPositions <= item) {
+        pq->numPositions *= 2;
+    }
 
-    for (int i = oldCapacity; i < pq->capacity; i++) {
+    pq->positions = realloc(pq->positions, pq->numPositions * sizeof(int));
+    if (pq->positions == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+    for (int i = oldSize; i < pq->numPositions; i++) {
         pq->positions[i] = -1;
     }
 }
 
 // helper function to maintain the heap property by moving an item up
+// the moving item is held aside and parents are shifted down into the hole
 static void heapifyUp(Pq pq, int index) {
+    int item = pq->items[index];
+    int priority = pq->priorities[index];
+
     while (index > 0) {
-        int parentIndex = (index - 1) / 2;
-        if (pq->items[index].priority >= pq->items[parentIndex].priority) {
+        int parentIndex = (index - 1) / PQ_ARITY;
+        if (priority >= pq->priorities[parentIndex]) {
             break;
         }
 
-        swap(pq, index, parentIndex);
+        pq->items[index] = pq->items[parentIndex];
+        pq->priorities[index] = pq->priorities[parentIndex];
+        pq->positions[pq->items[index]] = index;
         index = parentIndex;
     }
+
+    pq->items[index] = item;
+    pq->priorities[index] = priority;
+    pq->positions[item] = index;
 }
 
 // helper function to maintain the heap property by moving an item down
+// the moving item is held aside and the smallest child is shifted up into the hole
 static void heapifyDown(Pq pq, int index) {
-    int left = 2 * index + 1;
-    int right = 2 * index + 2;
-    int smallest = index;
+    int item = pq->items[index];
+    int priority = pq->priorities[index];
 
-    if (left < pq->numItems && pq->items[left].priority < pq->items[smallest].priority) {
-        smallest = left;
-    }
-    if (right < pq->numItems && pq->items[right].priority < pq->items[smallest].priority) {
-        smallest = right;
-    }
-    if (smallest != index) {
-        swap(pq, index, smallest);
-        heapifyDown(pq, smallest);
-    }
-}
+    while (true) {
+        int first = PQ_ARITY * index + 1;
+        if (first >= pq->numItems) {
+            break;
+        }
 
-// helper function to swap two items in the heap
-static void swap(Pq pq, int i, int j) {
-    struct pqItem temp = pq->items[i];
-    pq->items[i] = pq->items[j];
-    pq->items[j] = temp;
+        int last = first + PQ_ARITY < pq->numItems ? first + PQ_ARITY : pq->numItems;
+        int smallest = first;
+        for (int child = first + 1; child < last; child++) {
+            if (pq->priorities[child] < pq->priorities[smallest]) {
+                smallest = child;
+            }
+        }
+
+        if (pq->priorities[smallest] >= priority) {
+            break;
+        }
+
+        pq->items[index] = pq->items[smallest];
+        pq->priorities[index] = pq->priorities[smallest];
+        pq->positions[pq->items[index]] = index;
+        index = smallest;
+    }
 
-    pq->positions[pq->items[i].item] = i;
-    pq->positions[pq->items[j].item] = j;
+    pq->items[index] = item;
+    pq->priorities[index] = priority;
+    pq->positions[item] = index;
 }
\ No newline at end of file
@@ -1,16 +1,25 @@
 // Acknowledgements
 // - PriorityQueue ADT was taken from Pq.h from lectures
 // was modified to handle structures in stage 3
+// was modified to be an indexed d-ary heap in stage 3
 
 #ifndef PQ_H
 #define PQ_H
 
+#include <stdbool.h>
+
 typedef struct pq *Pq;
 
 Pq PqNew(void);
 
+// Creates a priority queue with room for the items 0 .. capacity - 1,
+// so that inserting them never has to grow the queue
+Pq PqNewWithCapacity(int capacity);
+
 void PqFree(Pq pq);
 
+// Inserts an item that is not already in the priority queue; use PqUpdate
+// to change the priority of one that is
 void PqInsert(Pq pq, int item, int priority);
 
 int PqSize(Pq pq);
@@ -21,4 +30,10 @@ void PqUpdate(Pq pq, int item, int priority);
 
 int PqPeek(Pq pq);
 
+// Returns true if the item is currently in the priority queue
+bool PqContains(Pq pq, int item);
+
+// Gets the priority of the item at the front of the priority queue
+int PqPeekPriority(Pq pq);
+
 #endif
@@ -1,37 +1,49 @@
 // Acknowledgements
 // - Queue ADT was taken from Queue.c from lectures
+// modified to be backed by a growable ring buffer
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "Queue.h"
 
+#define INITIAL_CAPACITY 16
+
+// The items live in a power-of-two sized circular array: the front of the
+// queue is at items[head] and item k is at items[(head + k) & (capacity - 1)]
 struct queue {
-	struct node *head;
-	struct node *tail;
+	Item *items;
+	int head;
 	int size;
+	int capacity;
 };
 
-struct node {
-	Item item;
-	struct node *next;
-};
-
-static struct node *newNode(Item it);
+static void reserve(Queue q, int capacity);
+static void resize(Queue q, int capacity);
 
 /**
  * Creates a new, empty Queue
  */
 Queue QueueNew(void) {
+	return QueueNewWithCapacity(INITIAL_CAPACITY);
+}
+
+/**
+ * Creates a new, empty Queue with room for at least capacity items
+ */
+Queue QueueNewWithCapacity(int capacity) {
 	Queue q = malloc(sizeof(struct queue));
 	if (q == NULL) {
 		fprintf(stderr, "error: out of memory\n");
 		exit(EXIT_FAILURE);
 	}
 
-	q->head = NULL;
-	q->tail = NULL;
+	q->items = NULL;
+	q->head = 0;
 	q->size = 0;
+	q->capacity = 0;
+	reserve(q, capacity < INITIAL_CAPACITY ? INITIAL_CAPACITY : capacity);
 	return q;
 }
 
@@ -39,12 +51,7 @@ Queue QueueNew(void) {
  * Frees memory allocated to a Queue
  */
 void QueueFree(Queue q) {
-	struct node *curr = q->head;
-	while (curr != NULL) {
-		struct node *temp = curr;
-		curr = curr->next;
-		free(temp);
-	}
+	free(q->items);
 	free(q);
 }
 
@@ -52,26 +59,12 @@ void QueueFree(Queue q) {
  * Adds an item to the end of a Queue
  */
 void QueueEnqueue(Queue q, Item it) {
-	struct node *n = newNode(it);
-	if (q->size == 0) {
-		q->head = n;
-	} else {
-		q->tail->next = n;
-	}
-	q->tail = n;
-	q->size++;
-}
-
-static struct node *newNode(Item it) {
-	struct node *n = malloc(sizeof(*n));
-	if (n == NULL) {
-		fprintf(stderr, "error: out of memory\n");
-		exit(EXIT_FAILURE);
+	if (q->size == q->capacity) {
+		resize(q, 2 * q->capacity);
 	}
 
-	n->item = it;
-	n->next = NULL;
-	return n;
+	q->items[(q->head + q->size) & (q->capacity - 1)] = it;
+	q->size++;
 }
 
 /**
@@ -84,14 +77,8 @@ Item QueueDequeue(Queue q) {
 		return 0;
 	}
 
-	struct node *newHead = q->head->next;
-	Item it = q->head->item;
-
-	free(q->head);
-	q->head = newHead;
-	if (newHead == NULL) {
-		q->tail = NULL;
-	}
+	Item it = q->items[q->head];
+	q->head = (q->head + 1) & (q->capacity - 1);
 	q->size--;
 
 	return it;
@@ -114,5 +101,40 @@ Item QueuePeek(Queue q) {
 		return 0;
 	}
 
-	return q->head->item;
+	return q->items[q->head];
+}
+
+// helper function to make room for at least capacity items, doubling
+// the array until it is big enough
+static void reserve(Queue q, int capacity) {
+	if (capacity <= q->capacity) {
+		return;
+	}
+
+	int newCapacity = q->capacity == 0 ? INITIAL_CAPACITY : q->capacity;
+	while (newCapacity < capacity) {
+		newCapacity *= 2;
+	}
+	resize(q, newCapacity);
+}
+
+// helper function to move the items into a new array of the given
+// power-of-two capacity, unwrapping them so the front is at index 0
+static void resize(Queue q, int capacity) {
+	Item *items = malloc(capacity * sizeof(Item));
+	if (items == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	int first = q->capacity - q->head < q->size ? q->capacity - q->head : q->size;
+	if (first > 0) {
+		memcpy(items, &q->items[q->head], first * sizeof(Item));
+		memcpy(&items[first], q->items, (q->size - first) * sizeof(Item));
+	}
+
+	free(q->items);
+	q->items = items;
+	q->head = 0;
+	q->capacity = capacity;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 // Acknowledgements
 // - Queue ADT was taken from Queue.c from lectures
+// modified to be backed by a growable ring buffer
 
 #ifndef QUEUE_H
 #define QUEUE_H
@@ -13,6 +14,11 @@ typedef struct queue *Queue;
  */
 Queue QueueNew(void);
 
+/**
+ * Creates a new, empty Queue with room for at least capacity items
+ */
+Queue QueueNewWithCapacity(int capacity);
+
 /**
  * Frees memory allocated to a Queue
  */
@@ -0,0 +1,849 @@
+// Dynamic reachability
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ReachIndex.h"
+
+// Every array indexed by component number has room for one component per
+// computer, which is as many as there can be. Numbers not in use are kept
+// on a free list. order lists the components so that every arc between two
+// of them goes from an earlier one to a later one, with -1 in the gaps that
+// merges leave, and position is the inverse of order
+struct reachIndex {
+	Graph g;
+	int numVert;
+	int *component;
+	int *nextMember;		// the next computer of the same component, or -1
+
+	int *firstMember;
+	int *size;
+	int *lowest;			// the lowest numbered computer of the component
+	int *numIn;				// the arcs into the component from others
+	int *reach;				// the computers it reaches, if reachKnown
+	bool *reachKnown;
+	int *position;
+	int numComponents;
+	int *freeIds;
+	int numFree;
+
+	int *order;
+	int orderSize;
+	int *spare;				// room to rebuild order in
+
+	// the arcs an update adds that have not been added yet, which searches
+	// have to skip over. firstOut[v] and firstIn[v] start lists (linked by
+	// nextOut and nextIn) of the added arcs out of and into v. before a
+	// search looks along v's arcs, the computers at the far end of v's
+	// pending arcs are stamped with pendingEpoch, so each arc is checked in
+	// O(1). markedRow is the computer whose arcs (in if markedIn, else
+	// out) are stamped, or -1
+	ReachArc *pending;
+	int numPending;
+	int nextPending;
+	int *firstOut;
+	int *firstIn;
+	int *nextOut;
+	int *nextIn;
+	unsigned int pendingEpoch;
+	unsigned int *pendingMark;
+	int markedRow;
+	bool markedIn;
+
+	// the components found by searches. a component has been found by the
+	// current search iff its mark is epoch
+	unsigned int epoch;
+	unsigned int *markForward;
+	unsigned int *markBackward;
+	int *forward;
+	int *backward;
+	int *pool;
+	int *before;
+	int *after;
+
+	// tarjan's algorithm, which finds the pieces of a component that may
+	// have come apart. pieces[pieceStart[k] ..] are the computers of piece
+	// k, the pieces coming out sinks first. splitFirst is the index in
+	// splitPieces of the first of the pieces a component came apart into,
+	// or -1 if it has not
+	int *index;
+	int *low;
+	int *nextArc;
+	int *callStack;
+	int *sccStack;
+	bool *onStack;
+	int *pieces;
+	int *pieceStart;
+	int *splitFirst;
+	int *splitCount;
+	int *splitPieces;
+	int numSplitPieces;
+};
+
+static void *allocArray(int n, size_t size);
+static int newComponent(ReachIndex ri);
+static bool isActive(ReachIndex ri, int from, int to, bool backward);
+static void markPending(ReachIndex ri, int v, bool backward);
+static int searchComponents(ReachIndex ri, int start, bool backward, int lo, int hi, unsigned int mark[], int found[]);
+static int findPieces(ReachIndex ri, int c);
+static bool splitComponent(ReachIndex ri, int c);
+static void rebuildOrder(ReachIndex ri);
+static void insertArc(ReachIndex ri, int u, int w);
+static int mergeComponents(ReachIndex ri, int numForward);
+static int countIn(ReachIndex ri, int c);
+static void forgetReach(ReachIndex ri, ReachArc arcs[], int numArcs);
+static void countReach(ReachIndex ri);
+static void sortPositions(ReachIndex ri, int positions[], int n);
+static int compareInts(const void *a, const void *b);
+
+ReachIndex ReachIndexNew(Graph g) {
+	int numVert = GraphNumVertices(g);
+	ReachIndex ri = malloc(sizeof(struct reachIndex));
+	if (ri == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	ri->g = g;
+	ri->numVert = numVert;
+	ri->component = allocArray(numVert, sizeof(int));
+	ri->nextMember = allocArray(numVert, sizeof(int));
+	ri->firstMember = allocArray(numVert, sizeof(int));
+	ri->size = allocArray(numVert, sizeof(int));
+	ri->lowest = allocArray(numVert, sizeof(int));
+	ri->numIn = allocArray(numVert, sizeof(int));
+	ri->reach = allocArray(numVert, sizeof(int));
+	ri->reachKnown = allocArray(numVert, sizeof(bool));
+	ri->position = allocArray(numVert, sizeof(int));
+	ri->freeIds = allocArray(numVert, sizeof(int));
+	ri->order = allocArray(numVert, sizeof(int));
+	ri->spare = allocArray(numVert, sizeof(int));
+	ri->firstOut = allocArray(numVert, sizeof(int));
+	ri->firstIn = allocArray(numVert, sizeof(int));
+	ri->pendingMark = allocArray(numVert, sizeof(unsigned int));
+	ri->markForward = allocArray(numVert, sizeof(unsigned int));
+	ri->markBackward = allocArray(numVert, sizeof(unsigned int));
+	ri->forward = allocArray(numVert, sizeof(int));
+	ri->backward = allocArray(numVert, sizeof(int));
+	ri->pool = allocArray(numVert, sizeof(int));
+	ri->before = allocArray(numVert, sizeof(int));
+	ri->after = allocArray(numVert, sizeof(int));
+	ri->index = allocArray(numVert, sizeof(int));
+	ri->low = allocArray(numVert, sizeof(int));
+	ri->nextArc = allocArray(numVert, sizeof(int));
+	ri->callStack = allocArray(numVert, sizeof(int));
+	ri->sccStack = allocArray(numVert, sizeof(int));
+	ri->onStack = allocArray(numVert, sizeof(bool));
+	ri->pieces = allocArray(numVert, sizeof(int));
+	ri->pieceStart = allocArray(numVert + 1, sizeof(int));
+	ri->splitFirst = allocArray(numVert, sizeof(int));
+	ri->splitCount = allocArray(numVert, sizeof(int));
+	ri->splitPieces = allocArray(numVert, sizeof(int));
+
+	ri->numPending = 0;
+	ri->nextPending = 0;
+	ri->pending = NULL;
+	ri->nextOut = NULL;
+	ri->nextIn = NULL;
+	ri->pendingEpoch = 0;
+	ri->markedRow = -1;
+	ri->markedIn = false;
+	ri->epoch = 0;
+	ri->numSplitPieces = 0;
+	ri->numFree = 0;
+	for (int c = numVert - 1; c >= 0; c--) {
+		ri->freeIds[ri->numFree++] = c;
+	}
+	for (int v = 0; v < numVert; v++) {
+		ri->firstOut[v] = -1;
+		ri->firstIn[v] = -1;
+		ri->pendingMark[v] = 0;
+		ri->markForward[v] = 0;
+		ri->markBackward[v] = 0;
+		ri->index[v] = -1;
+		ri->onStack[v] = false;
+		ri->splitFirst[v] = -1;
+	}
+
+	// start with every computer in one component, and split it up
+	ri->numComponents = 0;
+	ri->orderSize = 0;
+	if (numVert > 0) {
+		int c = newComponent(ri);
+		for (int v = 0; v < numVert; v++) {
+			ri->component[v] = c;
+			ri->nextMember[v] = v + 1 < numVert ? v + 1 : -1;
+		}
+		ri->firstMember[c] = 0;
+		ri->size[c] = numVert;
+		ri->lowest[c] = 0;
+		ri->numIn[c] = 0;
+		ri->reachKnown[c] = false;
+		ri->order[ri->orderSize++] = c;
+		ri->position[c] = 0;
+
+		if (splitComponent(ri, c)) {
+			rebuildOrder(ri);
+		}
+	}
+
+	return ri;
+}
+
+void ReachIndexFree(ReachIndex ri) {
+	free(ri->component);
+	free(ri->nextMember);
+	free(ri->firstMember);
+	free(ri->size);
+	free(ri->lowest);
+	free(ri->numIn);
+	free(ri->reach);
+	free(ri->reachKnown);
+	free(ri->position);
+	free(ri->freeIds);
+	free(ri->order);
+	free(ri->spare);
+	free(ri->firstOut);
+	free(ri->firstIn);
+	free(ri->pendingMark);
+	free(ri->markForward);
+	free(ri->markBackward);
+	free(ri->forward);
+	free(ri->backward);
+	free(ri->pool);
+	free(ri->before);
+	free(ri->after);
+	free(ri->index);
+	free(ri->low);
+	free(ri->nextArc);
+	free(ri->callStack);
+	free(ri->sccStack);
+	free(ri->onStack);
+	free(ri->pieces);
+	free(ri->pieceStart);
+	free(ri->splitFirst);
+	free(ri->splitCount);
+	free(ri->splitPieces);
+	free(ri);
+}
+
+void ReachIndexUpdate(
+	ReachIndex ri, ReachArc removed[], int numRemoved, ReachArc added[], int numAdded
+) {
+	// the added arcs are already in the graph, so searches skip them until
+	// they have been added to the index
+	ri->pending = added;
+	ri->numPending = numAdded;
+	ri->nextPending = 0;
+	ri->nextOut = allocArray(numAdded, sizeof(int));
+	ri->nextIn = allocArray(numAdded, sizeof(int));
+	for (int i = 0; i < numAdded; i++) {
+		ri->nextOut[i] = ri->firstOut[added[i].from];
+		ri->firstOut[added[i].from] = i;
+		ri->nextIn[i] = ri->firstIn[added[i].to];
+		ri->firstIn[added[i].to] = i;
+	}
+	ri->markedRow = -1;
+
+	// removing an arc between components leaves every component as it was,
+	// but one inside a component may split it. the arcs are counted off
+	// before any component splits, since a split counts its pieces' arcs
+	// in from scratch
+	ri->epoch++;
+	int numChecks = 0;
+	for (int i = 0; i < numRemoved; i++) {
+		int cu = ri->component[removed[i].from];
+		int cw = ri->component[removed[i].to];
+
+		if (cu != cw) {
+			ri->numIn[cw]--;
+		} else if (removed[i].from != removed[i].to && ri->markForward[cu] != ri->epoch) {
+			ri->markForward[cu] = ri->epoch;
+			ri->forward[numChecks++] = cu;
+		}
+	}
+
+	bool split = false;
+	for (int i = 0; i < numChecks; i++) {
+		split = splitComponent(ri, ri->forward[i]) || split;
+	}
+	if (split) {
+		rebuildOrder(ri);
+	}
+
+	for (int i = 0; i < numAdded; i++) {
+		ri->nextPending = i;		// an arc stays pending until it has been added
+		ri->markedRow = -1;
+		if (added[i].from != added[i].to) {
+			insertArc(ri, added[i].from, added[i].to);
+		}
+	}
+
+	for (int i = 0; i < numAdded; i++) {
+		ri->firstOut[added[i].from] = -1;
+		ri->firstIn[added[i].to] = -1;
+	}
+	free(ri->nextOut);
+	free(ri->nextIn);
+	ri->nextOut = NULL;
+	ri->nextIn = NULL;
+	ri->nextPending = numAdded;
+	ri->pending = NULL;
+	ri->numPending = 0;
+	ri->markedRow = -1;
+
+	if (ri->orderSize > 2 * ri->numComponents) {
+		rebuildOrder(ri);
+	}
+
+	forgetReach(ri, removed, numRemoved);
+	forgetReach(ri, added, numAdded);
+}
+
+int ReachIndexComponent(ReachIndex ri, int v) {
+	return ri->component[v];
+}
+
+int ReachIndexNumComponents(ReachIndex ri) {
+	return ri->numComponents;
+}
+
+int ReachIndexBestSource(ReachIndex ri, int *numReached) {
+	countReach(ri);
+
+	// only a source component can reach the most computers, since one that
+	// is not is reached by another that reaches all it does and more
+	int best = -1;
+	*numReached = 0;
+	for (int p = 0; p < ri->orderSize; p++) {
+		int c = ri->order[p];
+		if (c == -1 || ri->numIn[c] > 0) {
+			continue;
+		}
+
+		if (ri->reach[c] > *numReached || (ri->reach[c] == *numReached && ri->lowest[c] < best)) {
+			*numReached = ri->reach[c];
+			best = ri->lowest[c];
+		}
+	}
+
+	return best;
+}
+
+//////////////////////////////////////////////////////////
+
+// helper function to allocate an array of n items, exiting if there is
+// no memory for it
+static void *allocArray(int n, size_t size) {
+	void *a = malloc((n > 0 ? n : 1) * size);
+	if (a == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	return a;
+}
+
+// helper function to take a component number off the free list
+static int newComponent(ReachIndex ri) {
+	ri->numComponents++;
+	return ri->freeIds[--ri->numFree];
+}
+
+// helper function to check whether from -> to is an arc the index knows
+// about, i.e. not one of the arcs still to be added by an update. backward
+// says which end's arcs are being looked along: to's if it is set, else
+// from's
+static bool isActive(ReachIndex ri, int from, int to, bool backward) {
+	int v = backward ? to : from;
+	if ((backward ? ri->firstIn[v] : ri->firstOut[v]) == -1) {
+		return true;
+	}
+
+	markPending(ri, v, backward);
+	return ri->pendingMark[backward ? from : to] != ri->pendingEpoch;
+}
+
+// helper function to stamp the far ends of the pending arcs out of v (or
+// into v, if backward), unless they already are
+static void markPending(ReachIndex ri, int v, bool backward) {
+	if (ri->markedRow == v && ri->markedIn == backward) {
+		return;
+	}
+
+	ri->pendingEpoch++;
+	if (ri->pendingEpoch == 0) {		// the stamps wrapped around, so old ones could collide
+		for (int x = 0; x < ri->numVert; x++) {
+			ri->pendingMark[x] = 0;
+		}
+		ri->pendingEpoch = 1;
+	}
+
+	int i = backward ? ri->firstIn[v] : ri->firstOut[v];
+	for (; i != -1; i = backward ? ri->nextIn[i] : ri->nextOut[i]) {
+		if (i >= ri->nextPending) {
+			ri->pendingMark[backward ? ri->pending[i].from : ri->pending[i].to] = ri->pendingEpoch;
+		}
+	}
+
+	ri->markedRow = v;
+	ri->markedIn = backward;
+}
+
+// helper function to find the components start reaches (or that reach
+// start, if backward) without going outside positions lo to hi of the
+// order. the components found, start among them, are marked with the
+// current epoch and listed in found. returns how many there are
+static int searchComponents(ReachIndex ri, int start, bool backward, int lo, int hi, unsigned int mark[], int found[]) {
+	int numFound = 0;
+	mark[start] = ri->epoch;
+	found[numFound++] = start;
+
+	for (int i = 0; i < numFound; i++) {
+		int c = found[i];
+
+		for (int x = ri->firstMember[c]; x != -1; x = ri->nextMember[x]) {
+			GraphArcSpan arcs = backward ? GraphGetInArcs(ri->g, x) : GraphGetOutArcs(ri->g, x);
+
+			for (int k = 0; k < arcs.count; k++) {
+				int y = arcs.vertices[k];
+				int d = ri->component[y];
+				if (d == c || mark[d] == ri->epoch || ri->position[d] < lo || ri->position[d] > hi) {
+					continue;
+				}
+				if (!(backward ? isActive(ri, y, x, true) : isActive(ri, x, y, false))) {
+					continue;
+				}
+
+				mark[d] = ri->epoch;
+				found[numFound++] = d;
+			}
+		}
+	}
+
+	return numFound;
+}
+
+// helper function to find the strongly connected components of the
+// computers of c, along the arcs between them, with tarjan's algorithm.
+// leaves them in pieces, sinks first, and returns how many there are
+static int findPieces(ReachIndex ri, int c) {
+	int counter = 0;
+	int numPieces = 0;
+	int numDone = 0;
+	int sccTop = 0;
+	ri->pieceStart[0] = 0;
+
+	for (int root = ri->firstMember[c]; root != -1; root = ri->nextMember[root]) {
+		if (ri->index[root] != -1) {
+			continue;
+		}
+
+		int callTop = 0;
+		ri->callStack[callTop++] = root;
+		ri->index[root] = ri->low[root] = counter++;
+		ri->nextArc[root] = 0;
+		ri->sccStack[sccTop++] = root;
+		ri->onStack[root] = true;
+
+		while (callTop > 0) {
+			int v = ri->callStack[callTop - 1];
+			GraphArcSpan arcs = GraphGetOutArcs(ri->g, v);
+
+			if (ri->nextArc[v] < arcs.count) {
+				int w = arcs.vertices[ri->nextArc[v]++];
+				if (ri->component[w] != c || !isActive(ri, v, w, false)) {
+					continue;
+				}
+
+				if (ri->index[w] == -1) {
+					ri->index[w] = ri->low[w] = counter++;
+					ri->nextArc[w] = 0;
+					ri->sccStack[sccTop++] = w;
+					ri->onStack[w] = true;
+					ri->callStack[callTop++] = w;
+				} else if (ri->onStack[w] && ri->index[w] < ri->low[v]) {
+					ri->low[v] = ri->index[w];
+				}
+				continue;
+			}
+
+			callTop--;
+			if (callTop > 0) {
+				int parent = ri->callStack[callTop - 1];
+				if (ri->low[v] < ri->low[parent]) {
+					ri->low[parent] = ri->low[v];
+				}
+			}
+
+			if (ri->low[v] == ri->index[v]) {
+				int w;
+				do {
+					w = ri->sccStack[--sccTop];
+					ri->onStack[w] = false;
+					ri->pieces[numDone++] = w;
+				} while (w != v);
+				ri->pieceStart[++numPieces] = numDone;
+			}
+		}
+	}
+
+	for (int i = 0; i < numDone; i++) {
+		ri->index[ri->pieces[i]] = -1;
+	}
+
+	return numPieces;
+}
+
+// helper function to split c into its strongly connected components, if
+// it has come apart. the first of them (in topological order) keeps c's
+// number, and all of them are noted in splitPieces for rebuildOrder to put
+// in c's place. returns whether c split
+static bool splitComponent(ReachIndex ri, int c) {
+	int numPieces = findPieces(ri, c);
+	if (numPieces == 1) {
+		return false;
+	}
+
+	ri->numComponents--;
+	ri->splitFirst[c] = ri->numSplitPieces;
+	ri->splitCount[c] = numPieces;
+
+	for (int k = numPieces - 1; k >= 0; k--) {
+		int id = k == numPieces - 1 ? c : ri->freeIds[--ri->numFree];
+		ri->numComponents++;
+		ri->firstMember[id] = -1;
+		ri->size[id] = 0;
+		ri->lowest[id] = INT_MAX;
+		ri->reachKnown[id] = false;
+
+		for (int i = ri->pieceStart[k]; i < ri->pieceStart[k + 1]; i++) {
+			int v = ri->pieces[i];
+			ri->component[v] = id;
+			ri->nextMember[v] = ri->firstMember[id];
+			ri->firstMember[id] = v;
+			ri->size[id]++;
+			if (v < ri->lowest[id]) {
+				ri->lowest[id] = v;
+			}
+		}
+
+		ri->splitPieces[ri->numSplitPieces++] = id;
+	}
+
+	for (int i = ri->splitFirst[c]; i < ri->numSplitPieces; i++) {
+		ri->numIn[ri->splitPieces[i]] = countIn(ri, ri->splitPieces[i]);
+	}
+
+	return true;
+}
+
+// helper function to lay the order out again without gaps, putting the
+// pieces of every component that has split in its place
+static void rebuildOrder(ReachIndex ri) {
+	int n = 0;
+	for (int p = 0; p < ri->orderSize; p++) {
+		int c = ri->order[p];
+		if (c == -1) {
+			continue;
+		}
+
+		if (ri->splitFirst[c] == -1) {
+			ri->spare[n++] = c;
+		} else {
+			for (int i = 0; i < ri->splitCount[c]; i++) {
+				ri->spare[n++] = ri->splitPieces[ri->splitFirst[c] + i];
+			}
+			ri->splitFirst[c] = -1;
+		}
+	}
+	ri->numSplitPieces = 0;
+
+	int *order = ri->order;
+	ri->order = ri->spare;
+	ri->spare = order;
+	ri->orderSize = n;
+	for (int p = 0; p < n; p++) {
+		ri->position[ri->order[p]] = p;
+	}
+}
+
+// helper function to add the arc u -> w. if it goes against the order, the
+// components w reaches and those that reach u are found, only looking
+// between the two in the order. if u is among the first, the arc closes a
+// cycle and the components on it (those in both) merge. either way, the
+// positions of all of them are shared out again, those that reach u first
+// and then those w reaches, each keeping their order among themselves
+static void insertArc(ReachIndex ri, int u, int w) {
+	int cu = ri->component[u];
+	int cw = ri->component[w];
+	if (cu == cw) {
+		return;
+	}
+	if (ri->position[cu] < ri->position[cw]) {
+		ri->numIn[cw]++;
+		return;
+	}
+
+	int lo = ri->position[cw];
+	int hi = ri->position[cu];
+	ri->epoch++;
+	int numForward = searchComponents(ri, cw, false, lo, hi, ri->markForward, ri->forward);
+	int numBackward = searchComponents(ri, cu, true, lo, hi, ri->markBackward, ri->backward);
+	bool cycle = ri->markForward[cu] == ri->epoch;
+
+	int numPool = 0;
+	int numBefore = 0;
+	int numAfter = 0;
+	for (int i = 0; i < numForward; i++) {
+		int c = ri->forward[i];
+		ri->pool[numPool++] = ri->position[c];
+		if (ri->markBackward[c] != ri->epoch) {
+			ri->after[numAfter++] = ri->position[c];
+		}
+	}
+	for (int i = 0; i < numBackward; i++) {
+		int c = ri->backward[i];
+		if (ri->markForward[c] != ri->epoch) {
+			ri->pool[numPool++] = ri->position[c];
+			ri->before[numBefore++] = ri->position[c];
+		}
+	}
+
+	// turn the sorted positions back into components before they change
+	qsort(ri->pool, numPool, sizeof(int), compareInts);
+	sortPositions(ri, ri->before, numBefore);
+	sortPositions(ri, ri->after, numAfter);
+
+	int merged = -1;
+	if (cycle) {
+		merged = mergeComponents(ri, numForward);
+	} else {
+		ri->numIn[cw]++;
+	}
+
+	int k = 0;
+	for (int i = 0; i < numBefore; i++, k++) {
+		ri->order[ri->pool[k]] = ri->before[i];
+		ri->position[ri->before[i]] = ri->pool[k];
+	}
+	if (merged != -1) {
+		ri->order[ri->pool[k]] = merged;
+		ri->position[merged] = ri->pool[k++];
+	}
+	for (int i = 0; i < numAfter; i++, k++) {
+		ri->order[ri->pool[k]] = ri->after[i];
+		ri->position[ri->after[i]] = ri->pool[k];
+	}
+	for (; k < numPool; k++) {
+		ri->order[ri->pool[k]] = -1;
+	}
+}
+
+// helper function to merge the components found by both of insertArc's
+// searches into the largest of them. the others' computers move over, and
+// the arcs into the merged component are those into any of them, less
+// the arcs between them. returns the merged component
+static int mergeComponents(ReachIndex ri, int numForward) {
+	int survivor = -1;
+	int numIn = 0;
+	for (int i = 0; i < numForward; i++) {
+		int c = ri->forward[i];
+		if (ri->markBackward[c] == ri->epoch) {
+			numIn += ri->numIn[c];
+			if (survivor == -1 || ri->size[c] > ri->size[survivor]) {
+				survivor = c;
+			}
+		}
+	}
+
+	// every arc between two of the components has an end outside the
+	// survivor, so only the others' arcs are looked at
+	for (int i = 0; i < numForward; i++) {
+		int c = ri->forward[i];
+		if (ri->markBackward[c] != ri->epoch || c == survivor) {
+			continue;
+		}
+
+		for (int x = ri->firstMember[c]; x != -1; x = ri->nextMember[x]) {
+			GraphArcSpan out = GraphGetOutArcs(ri->g, x);
+			for (int k = 0; k < out.count; k++) {
+				int d = ri->component[out.vertices[k]];
+				if (d != c && ri->markForward[d] == ri->epoch && ri->markBackward[d] == ri->epoch
+					&& isActive(ri, x, out.vertices[k], false)) {
+					numIn--;
+				}
+			}
+
+			GraphArcSpan in = GraphGetInArcs(ri->g, x);
+			for (int k = 0; k < in.count; k++) {
+				if (ri->component[in.vertices[k]] == survivor && isActive(ri, in.vertices[k], x, true)) {
+					numIn--;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < numForward; i++) {
+		int c = ri->forward[i];
+		if (ri->markBackward[c] != ri->epoch || c == survivor) {
+			continue;
+		}
+
+		int last = -1;
+		for (int x = ri->firstMember[c]; x != -1; x = ri->nextMember[x]) {
+			ri->component[x] = survivor;
+			last = x;
+		}
+		ri->nextMember[last] = ri->firstMember[survivor];
+		ri->firstMember[survivor] = ri->firstMember[c];
+		ri->size[survivor] += ri->size[c];
+		if (ri->lowest[c] < ri->lowest[survivor]) {
+			ri->lowest[survivor] = ri->lowest[c];
+		}
+
+		ri->freeIds[ri->numFree++] = c;
+		ri->numComponents--;
+	}
+
+	ri->numIn[survivor] = numIn;
+	ri->reachKnown[survivor] = false;
+
+	return survivor;
+}
+
+// helper function to count the arcs into c from other components
+static int countIn(ReachIndex ri, int c) {
+	int numIn = 0;
+	for (int x = ri->firstMember[c]; x != -1; x = ri->nextMember[x]) {
+		GraphArcSpan arcs = GraphGetInArcs(ri->g, x);
+		for (int k = 0; k < arcs.count; k++) {
+			if (ri->component[arcs.vertices[k]] != c && isActive(ri, arcs.vertices[k], x, true)) {
+				numIn++;
+			}
+		}
+	}
+	return numIn;
+}
+
+// helper function to mark the counts of every component that reaches the
+// tail of one of arcs as out of date. a component whose reach has changed
+// must reach one: a path it has gained runs along the prefix of the path
+// up to its first new arc, and a path it has lost had a first removed arc
+// whose prefix is still there
+static void forgetReach(ReachIndex ri, ReachArc arcs[], int numArcs) {
+	ri->epoch++;
+	for (int i = 0; i < numArcs; i++) {
+		int c = ri->component[arcs[i].from];
+		if (ri->markBackward[c] == ri->epoch) {
+			continue;
+		}
+
+		int numFound = searchComponents(ri, c, true, 0, INT_MAX, ri->markBackward, ri->backward);
+		for (int k = 0; k < numFound; k++) {
+			ri->reachKnown[ri->backward[k]] = false;
+		}
+	}
+}
+
+// helper function to count what every source component whose count is out
+// of date reaches. the arcs between components are listed once, and a
+// batch of 64 sources at a time is swept down the order, each component
+// passing the sources that reach it on to its successors, so a component
+// is looked at once per batch however many computers it has
+static void countReach(ReachIndex ri) {
+	int *sources = ri->pool;
+	int numSources = 0;
+	for (int p = 0; p < ri->orderSize; p++) {
+		int c = ri->order[p];
+		if (c != -1 && ri->numIn[c] == 0 && !ri->reachKnown[c]) {
+			sources[numSources++] = c;
+		}
+	}
+	if (numSources == 0) {
+		return;
+	}
+
+	// successors[succStart[p] ..] are the components after the one at
+	// position p with an arc from it, each listed once
+	int *succStart = allocArray(ri->orderSize + 1, sizeof(int));
+	int *successors = allocArray(GraphNumArcs(ri->g), sizeof(int));
+	int numSuccessors = 0;
+	for (int p = 0; p < ri->orderSize; p++) {
+		succStart[p] = numSuccessors;
+		int c = ri->order[p];
+		if (c == -1) {
+			continue;
+		}
+
+		ri->epoch++;
+		for (int x = ri->firstMember[c]; x != -1; x = ri->nextMember[x]) {
+			GraphArcSpan arcs = GraphGetOutArcs(ri->g, x);
+			for (int k = 0; k < arcs.count; k++) {
+				int d = ri->component[arcs.vertices[k]];
+				if (d != c && ri->markForward[d] != ri->epoch) {
+					ri->markForward[d] = ri->epoch;
+					successors[numSuccessors++] = d;
+				}
+			}
+		}
+	}
+	succStart[ri->orderSize] = numSuccessors;
+
+	uint64_t *reachedBy = allocArray(ri->numVert, sizeof(uint64_t));
+	for (int c = 0; c < ri->numVert; c++) {
+		reachedBy[c] = 0;
+	}
+
+	for (int first = 0; first < numSources; first += 64) {
+		int batchSize = numSources - first < 64 ? numSources - first : 64;
+		for (int i = 0; i < batchSize; i++) {
+			int c = sources[first + i];
+			reachedBy[c] |= (uint64_t)1 << i;
+			ri->reach[c] = 0;
+		}
+
+		for (int p = ri->position[sources[first]]; p < ri->orderSize; p++) {
+			int c = ri->order[p];
+			if (c == -1 || reachedBy[c] == 0) {
+				continue;
+			}
+
+			uint64_t bits = reachedBy[c];
+			reachedBy[c] = 0;
+			for (int k = succStart[p]; k < succStart[p + 1]; k++) {
+				reachedBy[successors[k]] |= bits;
+			}
+			for (; bits != 0; bits &= bits - 1) {
+				ri->reach[sources[first + __builtin_ctzll(bits)]] += ri->size[c];
+			}
+		}
+
+		for (int i = 0; i < batchSize; i++) {
+			ri->reachKnown[sources[first + i]] = true;
+		}
+	}
+
+	free(succStart);
+	free(successors);
+	free(reachedBy);
+}
+
+// helper function to sort positions in the order and replace each with
+// the component there
+static void sortPositions(ReachIndex ri, int positions[], int n) {
+	qsort(positions, n, sizeof(int), compareInts);
+	for (int i = 0; i < n; i++) {
+		positions[i] = ri->order[positions[i]];
+	}
+}
+
+// helper function to compare ints for qsort
+static int compareInts(const void *a, const void *b) {
+	int x = *(int *)a;
+	int y = *(int *)b;
+
+	return (x > y) - (x < y);
+}
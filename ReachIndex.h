@@ -0,0 +1,56 @@
+// Dynamic reachability
+// Keeps the strongly connected components of a graph's arcs, in a
+// topological order, up to date as arcs come and go, along with how many
+// computers each source component (one that no other component has an arc
+// into) can reach. Removing an arc inside a component only searches that
+// component again, to see whether it has come apart. Adding an arc between
+// two components that goes against the order only searches the components
+// between them in it, merging those on the cycle it closes, if there is
+// one, and reordering the rest. A count is only found again once its
+// component reaches the tail of a changed arc.
+// The order is kept as in "A Dynamic Topological Sort Algorithm for
+// Directed Acyclic Graphs" (Pearce and Kelly, JEA 2006)
+
+#ifndef REACH_INDEX_H
+#define REACH_INDEX_H
+
+#include "Graph.h"
+
+typedef struct reachIndex *ReachIndex;
+
+// An arc from one computer to another
+typedef struct ReachArc {
+	int from;
+	int to;
+} ReachArc;
+
+// Builds an index over the arcs of g in O(V + E). The index keeps reading
+// g, so it has to be told about every change to g's arcs
+ReachIndex ReachIndexNew(Graph g);
+
+// Frees all memory allocated to an index
+void ReachIndexFree(ReachIndex ri);
+
+// Brings an index up to date once the arcs of its graph have changed,
+// where removed lists the arcs that have gone and added the ones that are
+// new. Arcs from a computer to itself make no difference, so they may be
+// left out
+void ReachIndexUpdate(
+	ReachIndex ri, ReachArc removed[], int numRemoved, ReachArc added[], int numAdded
+);
+
+// Returns the number of v's component. Two computers are in the same
+// component if and only if each can reach the other. Numbers are reused as
+// components merge and split
+int ReachIndexComponent(ReachIndex ri, int v);
+
+// Returns the number of components
+int ReachIndexNumComponents(ReachIndex ri);
+
+// Returns the computer that can reach the most computers, the lowest
+// numbered on ties, and sets *numReached to how many that is (itself
+// included). Only source components whose counts are out of date are
+// counted again. Returns -1, with *numReached 0, if there are no computers
+int ReachIndexBestSource(ReachIndex ri, int *numReached);
+
+#endif
@@ -1,26 +1,289 @@
 
 #include <assert.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "poodle.h"
+#include "PoodleNetwork.h"
 #include "Graph.h"
 #include "Queue.h"
 #include "PriorityQueue.h"
+#include "MultiSourceBfs.h"
+#include "BucketQueue.h"
+#include "DeltaStepping.h"
+#include "Alt.h"
+#include "ContractionHierarchy.h"
+#include "ReachIndex.h"
+
+// NETWORK HELPER FUNCTIONS
+static int threadCount(PoodleNetwork net);
+static struct searchWorkspace *networkSearch(PoodleNetwork net, Engine engine);
 
 // STAGE 1 HELPER FUNCTIONS
-static int connected(Graph pug, int start, bool visited[], int can_visit[], int *count);
-static void CreateGraph(Graph g, int numComputers, int numConnections, struct connection connections[], struct computer computers[]);
+static struct bfsWorkspace *bfsWorkspaceNew(int numVert);
+static void bfsWorkspaceFree(struct bfsWorkspace *ws);
+static int connected(Graph pug, struct bfsWorkspace *ws, int start, int reachable[]);
+static Graph CreateGraph(int numComputers, int numConnections, struct connection connections[], struct computer computers[]);
 
 // STAGE 2 HELPER FUNCTIONS
-static void insertionSort(int array[], int n);
+static int stronglyConnected(Graph pug, int component[]);
+static bool *sourceRepresentatives(Graph pug);
+static int maxReachCandidates(PoodleNetwork net, bool candidate[]);
+static ReachArc *arcsOut(Graph g, int computers[], int numComputers, int *numArcs);
+static void updateReachIndex(ReachIndex ri, Graph g, int computers[], int numComputers, ReachArc oldArcs[], int numOld);
+static int compareArcs(const void *a, const void *b);
 
 // STAGE 3 HELPER FUNCTIONS
-static void dijkstra(Graph g, int src, int dist[], bool sptSet[], struct computer computers[]);
+struct senders;
+struct searchWorkspace;
+struct stepStream;
+struct poodleBatch;
+static struct senders sendersNew(Graph g);
+static void sendersFree(struct senders *dag);
+static void sendersAdd(struct senders *dag, int computer, int sender);
+static void sendersFromTimes(Graph g, int dist[], struct senders *dag);
+static struct searchWorkspace *searchWorkspaceNew(Graph g, Engine engine);
+static void searchWorkspaceFree(struct searchWorkspace *ws);
+static void searchWorkspaceReset(struct searchWorkspace *ws);
+static int dijkstra(Graph g, struct searchWorkspace *ws, int sources[], int numSources, int deadline, int maxSteps, struct stepStream *stream);
+static void sortRun(int order[], int first, int last);
+static bool isRecipient(int dist[], int v, int u, int cost);
+static void streamSteps(Graph g, int dist[], int order[], int numSettled, long long time, struct stepStream *stream);
+static struct frontier frontierNew(Graph g, Engine engine);
+static void frontierFree(struct frontier *f);
+static void frontierPush(struct frontier *f, int v, int time);
+static int frontierPop(struct frontier *f);
+static int frontierSize(struct frontier *f);
+static void frontierClear(struct frontier *f);
+static struct poodlePlan searchPlan(PoodleNetwork net, int sources[], int numSources, int deadline, int maxSteps);
+static int sortSources(Graph g, int sources[], int numSources, int sorted[]);
+static struct poodlePlan createPlan(Graph g, struct searchWorkspace *ws, int numSettled, int numSteps);
+static bool inPlan(struct searchWorkspace *ws, int computer, int numSteps);
+static void orderByTime(int order[], int numSteps, int dist[]);
 static int compareSteps(const void *a, const void *b);
-static struct poodleResult returnResult(Graph g, int dist[], int numComputers, struct computer computers[]);
-static struct computerList *createRecipientList(Graph g, int computer, int dist[], struct computer computers[]);
+static int compareComputers(const void *a, const void *b);
+static struct poodleResult planToResult(struct poodlePlan plan, bool packed);
+static void runBatch(PoodleNetwork net, struct poodleBatch *batch);
+static void *batchWorker(void *arg);
+struct trackedPlan;
+static struct trackedPlan *trackedPlanNew(int numVert, int source);
+static void trackedPlanFree(struct trackedPlan *tp);
+static int *changedHeads(Graph g, struct networkChange changes[], int numChanges, int *numHeads);
+static void trackedPlanUpdate(Graph g, struct trackedPlan *tp, int heads[], int numHeads);
+static bool timeStands(Graph g, struct trackedPlan *tp, int u);
+static void reseed(Graph g, struct trackedPlan *tp, int u);
+static void lowerTime(struct trackedPlan *tp, int u, int time);
+struct linkAnalysis;
+static int linkCandidates(Graph g, struct searchWorkspace *ws, int numSettled, int source, struct linkImpact **candidates);
+static void runLinkAnalysis(PoodleNetwork net, struct linkAnalysis *analysis);
+static void *linkWorker(void *arg);
+static void evaluateLink(struct linkAnalysis *analysis, bool lost[], int time[], int lostList[], Pq pq, struct linkImpact *impact);
+static bool keepsTime(struct senders *dag, int dist[], bool lost[], struct connection link, int u);
+static bool onLink(struct connection link, int v, int w);
+static int compareLinks(const void *a, const void *b);
+static int compareImpacts(const void *a, const void *b);
+
+// a reusable workspace for single-source reachability searches. a computer has been visited by the
+// current search iff mark[v] == epoch, in which case level[v] is its bfs depth, so starting a new
+// search only bumps the epoch. reached is a bitmap of the computers found, from which they can be
+// listed in ascending order in linear time
+struct bfsWorkspace {
+	int numVert;
+	unsigned int epoch;
+	unsigned int *mark;
+	int *level;
+	uint64_t *reached;
+	Queue q;
+};
+
+// direction-optimizing bfs switches to bottom-up once the frontier has more than 1/BFS_ALPHA of the
+// unexplored edges, and back to top-down once it holds fewer than 1/BFS_BETA of the computers
+// (the values suggested by Beamer et al., "Direction-Optimizing Breadth-First Search", SC 2012)
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+// the queue of reached but unsettled computers in dijkstra, backed by whichever engine was chosen
+struct frontier {
+	Engine engine;
+	Pq pq;
+	BucketQueue bq;
+};
+
+// the shortest path dag found by task 3's search: for every computer u, the computers v it could have been
+// sent the pug by, i.e. those with an arc v -> u and dist[v] + cost == dist[u]. the entries form one linked
+// list per computer in a pool with room for one entry per arc, since dijkstra looks at each arc once
+struct senders {
+	int *first;		// the first entry of each computer's list, or -1
+	int *sender;
+	int *next;
+	int size;
+};
+
+// the reusable state of task 3 searches. outside of a search every dist is INFINITE, no computer is in
+// sptSet, every list of senders is empty and the frontier is empty, so a search only has to clean up after
+// the computers it reached (listed in reached) and costs nothing for the parts of the network it never sees
+struct searchWorkspace {
+	Engine engine;				// the engine asked for when the frontier was made
+	struct frontier pq;
+	int *dist;
+	bool *sptSet;
+	struct senders dag;
+	int *order;					// the computers settled, in the order of the plan
+	int *position;				// the index of each settled computer in order
+	int *reached;
+	int numReached;
+};
+
+// a streamed task 3 query: the steps in order[] before emitted have been handed to the callback. the
+// rest are held back until every computer they could send the pug to has been settled
+struct stepStream {
+	PoodleStepCallback callback;
+	void *context;
+	int emitted;
+	int *recipients;				// the recipients of the step being emitted
+	struct computerList *nodes;		// and its recipient list
+	int capacity;
+};
+
+// a batch of task 3 queries, one per source, shared between threads that each claim the next source with an
+// atomic add on next. every thread has its own workspace, and the graph is only read. results (or
+// summaries, whichever is not NULL) has one entry per source
+struct poodleBatch {
+	Graph g;
+	Engine engine;
+	int *sources;
+	int numSources;
+	int next;
+	struct poodleResult *results;
+	struct poodleSummary *summaries;
+};
+
+// one thread's share of a batch
+struct batchWorker {
+	struct poodleBatch *batch;
+	struct searchWorkspace *ws;
+};
+
+// a task 3 plan kept up to date as its network changes: the time of every computer when source is poodled
+// first, or INT_MAX if it never is. the shortest path dag is every arc v -> u with dist[v] + cost == dist[u],
+// so it is kept along with the times. lost, invalid and pq are for updates, and are clear between them
+struct trackedPlan {
+	int source;
+	int *dist;
+	int *lost;			// the computers whose times no longer stand
+	bool *invalid;		// likewise, as a flag per computer
+	Pq pq;
+};
+
+// a critical link analysis, shared between threads that each claim the next candidate connection with an
+// atomic add on next. the search from source (its times, shortest path dag and order) is only read
+struct linkAnalysis {
+	Graph g;
+	int source;
+	struct searchWorkspace *ws;
+	int numSettled;
+	struct linkImpact *impacts;		// one per candidate, with only its connection filled in to start with
+	int numLinks;
+	int next;
+};
+
+// one thread's share of a critical link analysis
+struct linkWorker {
+	struct linkAnalysis *analysis;
+};
+
+// the largest step cost (transmission time plus the receiver's poodle time) the bucket queue is used for.
+// dial's algorithm needs one bucket per possible step cost and may walk over that many empty buckets
+// per computer settled, so beyond this the heap is faster
+#define BUCKET_QUEUE_MAX_STEP (1 << 16)
+
+// ENGINE_AUTO only uses the bucket queue when the largest step cost is also at most this many times the
+// number of computers. the buckets then take no more memory than the rest of the search, and the empty ones
+// walked over cost no more than the heap would: on random networks the heap caught up at around 16 times
+#define BUCKET_QUEUE_AUTO_RATIO 4
+
+// the number of landmarks point-to-point queries use. each costs two full searches when the network is
+// first queried, and four ints of memory per computer
+#define ALT_LANDMARKS 8
+
+struct poodleNetwork {
+	Graph pug;
+	Engine engine;
+	int numThreads;					// 0 for one per online processor
+	struct bfsWorkspace *reach;		// created by the first query that needs it
+	struct searchWorkspace *search;	// likewise
+	Alt alt;						// likewise
+	ContractionHierarchy hierarchy;	// only built when asked for
+	struct trackedPlan *tracked;	// likewise
+	ReachIndex reachIndex;			// created by the first task 2 query
+};
+
+////////////////////////////////////////////////////////////////////////
+// Network handle
+
+PoodleNetwork PoodleNetworkNew(
+	struct computer computers[], int numComputers,
+	struct connection connections[], int numConnections
+) {
+	PoodleNetwork net = malloc(sizeof(struct poodleNetwork));
+
+	if (net == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	net->pug = CreateGraph(numComputers, numConnections, connections, computers);
+	net->engine = ENGINE_AUTO;
+	net->numThreads = 0;
+	net->reach = NULL;
+	net->search = NULL;
+	net->alt = NULL;
+	net->hierarchy = NULL;
+	net->tracked = NULL;
+	net->reachIndex = NULL;
+
+	return net;
+}
+
+void PoodleNetworkFree(PoodleNetwork net) {
+	if (net->reach != NULL) {
+		bfsWorkspaceFree(net->reach);
+	}
+	if (net->search != NULL) {
+		searchWorkspaceFree(net->search);
+	}
+	if (net->alt != NULL) {
+		AltFree(net->alt);
+	}
+	if (net->hierarchy != NULL) {
+		ChFree(net->hierarchy);
+	}
+	if (net->tracked != NULL) {
+		trackedPlanFree(net->tracked);
+	}
+	if (net->reachIndex != NULL) {
+		ReachIndexFree(net->reachIndex);
+	}
+	GraphFree(net->pug);
+	free(net);
+}
+
+int PoodleNetworkNumComputers(PoodleNetwork net) {
+	return GraphNumVertices(net->pug);
+}
+
+void PoodleNetworkSetEngine(PoodleNetwork net, Engine engine) {
+	net->engine = engine;
+}
+
+void PoodleNetworkSetThreads(PoodleNetwork net, int numThreads) {
+	net->numThreads = numThreads;
+}
 
 ////////////////////////////////////////////////////////////////////////
 // Task 1
@@ -29,18 +292,26 @@ struct probePathResult probePath(
 	struct computer computers[], int numComputers,
 	struct connection connections[], int numConnections,
 	int path[], int pathLength
+) {
+	PoodleNetwork net = PoodleNetworkNew(computers, numComputers, connections, numConnections);
+	struct probePathResult res = PoodleNetworkProbePath(net, path, pathLength);
+	PoodleNetworkFree(net);
+
+	return res;
+}
+
+struct probePathResult PoodleNetworkProbePath(
+	PoodleNetwork net, int path[], int pathLength
 ) {
 	struct probePathResult res = {SUCCESS, 0};
 	
-	Graph pug = GraphNew(numComputers);
-	CreateGraph(pug, numComputers, numConnections, connections, computers);
+	Graph pug = net->pug;
 
-	bool *visited = calloc(numComputers, sizeof(bool));
+	bool *visited = calloc(GraphNumVertices(pug), sizeof(bool));
 
 	if (pathLength == 1) {
 		res.elapsedTime += GraphGetPoodleTime(pug, path[0]);
 		visited[path[0]] = true;
-		GraphFree(pug);
 		free(visited);
 
 		return res;
@@ -57,14 +328,12 @@ struct probePathResult probePath(
 
 		if (GraphIsAdjacent(pug, first, second) == false) {
 			res.status = NO_CONNECTION;
-			GraphFree(pug);
 			free(visited);
 			return res;
 		}
 
 		if (GraphGetSecurityLevel(pug, first) + 1 < GraphGetSecurityLevel(pug, second)) {
 			res.status = NO_PERMISSION;
-			GraphFree(pug);
 			free(visited);
 			return res;
 		}
@@ -78,7 +347,6 @@ struct probePathResult probePath(
 		}
 	}
 
-	GraphFree(pug);
 	free(visited);
 
 	return res;
@@ -91,44 +359,43 @@ struct chooseSourceResult chooseSource(
 	struct computer computers[], int numComputers,
 	struct connection connections[], int numConnections
 ) {
-	struct chooseSourceResult res = {0, 0, NULL};
-
-	Graph pug = GraphNew(numComputers);
-	CreateGraph(pug, numComputers, numConnections, connections, computers);
+	PoodleNetwork net = PoodleNetworkNew(computers, numComputers, connections, numConnections);
+	struct chooseSourceResult res = PoodleNetworkChooseSource(net);
+	PoodleNetworkFree(net);
 
-	int max_computers_visited = 0;
-	int optimal_source = -1;
-	int *optimal_computer = NULL; 
+	return res;
+}
 
-	for (int k = 0; k < numComputers; k++) {
-		bool *visited = calloc(numComputers, sizeof(bool));
-		int *can_visit = calloc(numComputers, sizeof(int));
+struct chooseSourceResult PoodleNetworkChooseSource(PoodleNetwork net) {
+	struct chooseSourceResult res = {0, 0, NULL};
 
-		int count = 0;
-		int computers_visited = connected(pug, k, visited, can_visit, &count);
+	Graph pug = net->pug;
+	int numComputers = GraphNumVertices(pug);
 
-		if (computers_visited > max_computers_visited) {
-			max_computers_visited = computers_visited;
-			optimal_source = k;
+	// the index keeps each source component's count, and only counts again the ones changes have touched
+	if (net->reachIndex == NULL) {
+		net->reachIndex = ReachIndexNew(pug);
+	}
 
-			if (optimal_computer != NULL) {
-				free(optimal_computer);
-			}
+	int max_computers_visited = 0;
+	int optimal_source = ReachIndexBestSource(net->reachIndex, &max_computers_visited);
+	int *optimal_computer = NULL;
 
-			optimal_computer = malloc(computers_visited * sizeof(int));
-			for (int l = 0; l < computers_visited; l++) {
-				optimal_computer[l] = can_visit[l];
-			}
+	if (optimal_source != -1) {
+		if (net->reach == NULL) {
+			net->reach = bfsWorkspaceNew(numComputers);
+		}
 
-			insertionSort(optimal_computer, computers_visited);
+		optimal_computer = malloc(max_computers_visited * sizeof(int));
+		if (optimal_computer == NULL) {
+			fprintf(stderr, "Error: out of memory");
+			exit(1);
 		}
 
-		free(visited);
-		free(can_visit);
+		int computers_visited = connected(pug, net->reach, optimal_source, optimal_computer);
+		assert(computers_visited == max_computers_visited);
 	}
 
-	GraphFree(pug);
-
 	res.sourceComputer = optimal_source;
 	res.numComputers = max_computers_visited;
 	res.computers = optimal_computer;
@@ -136,6 +403,31 @@ struct chooseSourceResult chooseSource(
 	return res;
 }
 
+int PoodleNetworkReachable(PoodleNetwork net, int source, int reachable[]) {
+	if (net->reach == NULL) {
+		net->reach = bfsWorkspaceNew(GraphNumVertices(net->pug));
+	}
+
+	return connected(net->pug, net->reach, source, reachable);
+}
+
+void PoodleNetworkReachableCounts(
+	PoodleNetwork net, int sources[], int numSources, int counts[]
+) {
+	if (numSources == 0) {
+		return;
+	}
+
+	MsBfs bfs = MsBfsNew(net->pug, numSources < MSBFS_MAX_SOURCES ? numSources : MSBFS_MAX_SOURCES);
+
+	for (int first = 0; first < numSources; first += MSBFS_MAX_SOURCES) {
+		int batchSize = numSources - first < MSBFS_MAX_SOURCES ? numSources - first : MSBFS_MAX_SOURCES;
+		MsBfsRun(bfs, &sources[first], batchSize, &counts[first]);
+	}
+
+	MsBfsFree(bfs);
+}
+
 ////////////////////////////////////////////////////////////////////////
 // Task 3
 
@@ -144,30 +436,343 @@ struct poodleResult poodle(
 	struct connection connections[], int numConnections,
 	int sourceComputer
 ) {
-	struct poodleResult res = {0, NULL};
+	PoodleNetwork net = PoodleNetworkNew(computers, numComputers, connections, numConnections);
+	struct poodleResult res = PoodleNetworkPoodle(net, sourceComputer);
+	PoodleNetworkFree(net);
+
+	return res;
+}
+
+struct poodleResult PoodleNetworkPoodle(PoodleNetwork net, int sourceComputer) {
+	return PoodleNetworkPoodleBounded(net, sourceComputer, INFINITY, GraphNumVertices(net->pug));
+}
+
+struct poodleResult PoodleNetworkPoodleBounded(
+	PoodleNetwork net, int sourceComputer, int deadline, int maxSteps
+) {
+	struct poodlePlan plan = searchPlan(net, &sourceComputer, 1, deadline, maxSteps);
+	struct poodleResult res = planToResult(plan, false);
+	PoodlePlanFree(plan);
+
+	return res;
+}
+
+struct poodleResult PoodleNetworkPoodlePacked(PoodleNetwork net, int sourceComputer) {
+	struct poodlePlan plan = searchPlan(net, &sourceComputer, 1, INFINITY, GraphNumVertices(net->pug));
+	struct poodleResult res = planToResult(plan, true);
+	PoodlePlanFree(plan);
+
+	return res;
+}
+
+struct poodlePlan PoodleNetworkPoodlePlan(PoodleNetwork net, int sourceComputer) {
+	return searchPlan(net, &sourceComputer, 1, INFINITY, GraphNumVertices(net->pug));
+}
+
+void PoodlePlanFree(struct poodlePlan plan) {
+	free(plan.computers);
+}
+
+struct poodleResult PoodleNetworkPoodleMultiSource(PoodleNetwork net, int sources[], int numSources) {
+	int *sorted = malloc(numSources * sizeof(int));
+	if (numSources > 0 && sorted == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
 
-	Graph pug = GraphNew(numComputers);
-	CreateGraph(pug, numComputers, numConnections, connections, computers);
+	int numSorted = sortSources(net->pug, sources, numSources, sorted);
+	struct poodlePlan plan = searchPlan(net, sorted, numSorted, INFINITY, GraphNumVertices(net->pug));
+	struct poodleResult res = planToResult(plan, false);
+	PoodlePlanFree(plan);
+	free(sorted);
 
-	int *dist = malloc(numComputers * sizeof(int));
-	bool *sptSet = malloc(numComputers * sizeof(bool));
+	return res;
+}
+
+void PoodleNetworkPoodleBatch(
+	PoodleNetwork net, int sources[], int numSources, struct poodleResult results[]
+) {
+	Engine engine = net->engine == ENGINE_PARALLEL ? ENGINE_AUTO : net->engine;
+	struct poodleBatch batch = {net->pug, engine, sources, numSources, 0, results, NULL};
+	runBatch(net, &batch);
+}
+
+void PoodleNetworkPoodleSummaries(
+	PoodleNetwork net, int sources[], int numSources, struct poodleSummary summaries[]
+) {
+	Engine engine = net->engine == ENGINE_PARALLEL ? ENGINE_AUTO : net->engine;
+	struct poodleBatch batch = {net->pug, engine, sources, numSources, 0, NULL, summaries};
+	runBatch(net, &batch);
+}
 
-	if (dist == NULL || sptSet == NULL) {
+struct fastestSourceResult PoodleNetworkFastestSource(PoodleNetwork net) {
+	struct fastestSourceResult res = {-1, 0, INFINITY};
+
+	Graph pug = net->pug;
+	int numComputers = GraphNumVertices(pug);
+	Engine engine = net->engine == ENGINE_PARALLEL ? ENGINE_AUTO : net->engine;
+
+	bool *candidate = calloc(numComputers, sizeof(bool));
+	int *bound = malloc(numComputers * sizeof(int));
+	if (numComputers > 0 && (candidate == NULL || bound == NULL)) {
 		fprintf(stderr, "Error: out of memory");
 		exit(1);
 	}
 
-	dijkstra(pug, sourceComputer, dist, sptSet, computers);
+	res.numComputers = maxReachCandidates(net, candidate);
+	struct searchWorkspace *ws = networkSearch(net, engine);
+
+	// bound[v] is a lower bound on candidate v's makespan, starting from its own poodle time. candidates are
+	// searched lowest bound first, and once the lowest bound left is past the best makespan so far none of
+	// the rest can win
+	Pq queue = PqNewWithCapacity(numComputers);
+	for (int v = 0; v < numComputers; v++) {
+		if (candidate[v]) {
+			bound[v] = GraphGetPoodleTime(pug, v);
+			PqInsert(queue, v, bound[v]);
+		}
+	}
+
+	while (PqSize(queue) > 0) {
+		int lowest = PqPeekPriority(queue);
+		int c = PqDelete(queue);
+		candidate[c] = false;
+
+		if (res.sourceComputer != -1 && lowest > res.makespan) {
+			break;
+		}
+		if (res.sourceComputer != -1 && lowest == res.makespan && c > res.sourceComputer) {
+			continue;
+		}
+
+		// c has to finish before the best so far, or at the same time if it is a lower numbered computer, so
+		// its search can stop as soon as it is too late
+		int deadline = INFINITY;
+		if (res.sourceComputer != -1) {
+			deadline = c < res.sourceComputer ? res.makespan : res.makespan - 1;
+		}
+
+		int numSettled = dijkstra(pug, ws, &c, 1, deadline, numComputers, NULL);
+
+		// late is c's makespan if its search finished, and a lower bound on it otherwise. a search without a
+		// deadline only falls short when some computer would take INT_MAX seconds or more, as in the full plan
+		long long late;
+		if (numSettled == res.numComputers) {
+			late = ws->dist[ws->order[numSettled - 1]];
+		} else if (deadline == INFINITY) {
+			late = INFINITY;
+		} else {
+			late = (long long)deadline + 1;
+		}
+		if (late <= deadline) {
+			res.sourceComputer = c;
+			res.makespan = late;
+		}
+
+		// every candidate x that c reaches reaches the same computers, so d(x, y) >= d(c, y) - d(c, x) for
+		// all of them, and x's makespan is at least its poodle time plus late less c's time to x. a time to x
+		// not yet settled is too high, which only loosens the bound
+		for (int i = 0; i < ws->numReached; i++) {
+			int x = ws->reached[i];
+			if (!candidate[x]) {
+				continue;
+			}
+
+			long long lower = GraphGetPoodleTime(pug, x) + late - ws->dist[x];
+			if (lower > INFINITY) {
+				lower = INFINITY;
+			}
+			if (lower > bound[x]) {
+				bound[x] = lower;
+				PqUpdate(queue, x, bound[x]);
+			}
+		}
+
+		searchWorkspaceReset(ws);
+	}
+
+	PqFree(queue);
+	free(candidate);
+	free(bound);
+
+	return res;
+}
+
+void PoodleNetworkPoodleStream(
+	PoodleNetwork net, int sourceComputer,
+	PoodleStepCallback callback, void *context
+) {
+	Graph pug = net->pug;
+	Engine engine = net->engine == ENGINE_PARALLEL ? ENGINE_AUTO : net->engine;
+	struct searchWorkspace *ws = networkSearch(net, engine);
+
+	struct stepStream stream = {callback, context, 0, NULL, NULL, 0};
+	dijkstra(pug, ws, &sourceComputer, 1, INFINITY, GraphNumVertices(pug), &stream);
+	searchWorkspaceReset(ws);
+
+	free(stream.recipients);
+	free(stream.nodes);
+}
+
+int PoodleNetworkPoodleTime(PoodleNetwork net, int sourceComputer, int computer) {
+	Graph pug = net->pug;
+	int poodleTime = GraphGetPoodleTime(pug, sourceComputer);
+
+	// the source takes its own poodle time, then every step costs its arc's cost. like the full search, a
+	// computer that would take INT_MAX seconds or more is never poodled
+	int distance;
+	if (net->hierarchy != NULL) {
+		distance = ChDistance(net->hierarchy, sourceComputer, computer, INT_MAX - poodleTime);
+	} else {
+		if (net->alt == NULL) {
+			net->alt = AltNew(pug, ALT_LANDMARKS);
+		}
+		distance = AltDistance(net->alt, sourceComputer, computer, INT_MAX - poodleTime);
+	}
+
+	return distance == -1 ? INFINITY : poodleTime + distance;
+}
+
+void PoodleNetworkPrepareHierarchy(PoodleNetwork net) {
+	if (net->hierarchy == NULL) {
+		net->hierarchy = ChNew(net->pug);
+	}
+}
+
+void PoodleNetworkApplyChanges(
+	PoodleNetwork net, struct networkChange changes[], int numChanges
+) {
+	Graph pug = net->pug;
+
+	// the computers whose arcs out or in the changes may touch, and what they had before
+	int numHeads = 0;
+	int *heads = changedHeads(pug, changes, numChanges, &numHeads);
+	int numOldArcs = 0;
+	ReachArc *oldArcs = net->reachIndex != NULL ? arcsOut(pug, heads, numHeads, &numOldArcs) : NULL;
+
+	GraphBeginChanges(pug);
+	for (int i = 0; i < numChanges; i++) {
+		struct connection c = changes[i].connection;
+
+		if (changes[i].kind == CHANGE_ADD_CONNECTION) {
+			GraphInsertEdge(pug, c.computerA, c.computerB, c.transmissionTime);
+		} else if (changes[i].kind == CHANGE_REMOVE_CONNECTION) {
+			GraphRemoveEdge(pug, c.computerA, c.computerB);
+		} else {
+			GraphSetVertexInfo(pug, changes[i].computer, changes[i].info.securityLevel, changes[i].info.poodleTime);
+		}
+	}
+	GraphEndChanges(pug);
+
+	// the workspace is sized for the old arcs, and the landmarks and hierarchy hold their distances
+	if (net->search != NULL) {
+		searchWorkspaceFree(net->search);
+		net->search = NULL;
+	}
+	if (net->alt != NULL) {
+		AltFree(net->alt);
+		net->alt = NULL;
+	}
+	if (net->hierarchy != NULL) {
+		ChFree(net->hierarchy);
+		net->hierarchy = NULL;
+	}
+
+	if (net->tracked != NULL) {
+		trackedPlanUpdate(pug, net->tracked, heads, numHeads);
+	}
+	if (net->reachIndex != NULL) {
+		updateReachIndex(net->reachIndex, pug, heads, numHeads, oldArcs, numOldArcs);
+	}
+
+	free(heads);
+	free(oldArcs);
+}
+
+void PoodleNetworkTrack(PoodleNetwork net, int sourceComputer) {
+	Graph pug = net->pug;
+	int numComputers = GraphNumVertices(pug);
+	assert(sourceComputer >= -1 && sourceComputer < numComputers);
+
+	if (net->tracked != NULL) {
+		trackedPlanFree(net->tracked);
+		net->tracked = NULL;
+	}
+	if (sourceComputer == -1) {
+		return;
+	}
+
+	Engine engine = net->engine == ENGINE_PARALLEL ? ENGINE_AUTO : net->engine;
+	struct searchWorkspace *ws = networkSearch(net, engine);
+	dijkstra(pug, ws, &sourceComputer, 1, INFINITY, numComputers, NULL);
+
+	net->tracked = trackedPlanNew(numComputers, sourceComputer);
+	memcpy(net->tracked->dist, ws->dist, numComputers * sizeof(int));
+	searchWorkspaceReset(ws);
+}
 
-	res = returnResult(pug, dist, numComputers, computers);
+struct poodleResult PoodleNetworkTrackedPoodle(PoodleNetwork net) {
+	assert(net->tracked != NULL);
+	Graph pug = net->pug;
+	int *dist = net->tracked->dist;
+
+	// lay the times out as if a search had just found them, as for delta-stepping
+	Engine engine = net->engine == ENGINE_PARALLEL ? ENGINE_AUTO : net->engine;
+	struct searchWorkspace *ws = networkSearch(net, engine);
+	int numSettled = 0;
+	for (int v = 0; v < GraphNumVertices(pug); v++) {
+		if (dist[v] != INT_MAX) {
+			ws->dist[v] = dist[v];
+			ws->reached[ws->numReached++] = v;
+			ws->order[numSettled++] = v;
+			ws->sptSet[v] = true;
+		}
+	}
+	sendersFromTimes(pug, ws->dist, &ws->dag);
+	orderByTime(ws->order, numSettled, ws->dist);
 
-	free(dist);
-	free(sptSet);
-	GraphFree(pug);
+	struct poodlePlan plan = createPlan(pug, ws, numSettled, numSettled);
+	searchWorkspaceReset(ws);
+	struct poodleResult res = planToResult(plan, false);
+	PoodlePlanFree(plan);
 
 	return res;
 }
 
+int PoodleNetworkTrackedTime(PoodleNetwork net, int computer) {
+	assert(net->tracked != NULL);
+	assert(computer >= 0 && computer < GraphNumVertices(net->pug));
+
+	return net->tracked->dist[computer];
+}
+
+struct linkImpact *PoodleNetworkCriticalLinks(PoodleNetwork net, int sourceComputer, int *numLinks) {
+	Graph pug = net->pug;
+	int numComputers = GraphNumVertices(pug);
+	assert(sourceComputer >= 0 && sourceComputer < numComputers);
+
+	Engine engine = net->engine == ENGINE_PARALLEL ? ENGINE_AUTO : net->engine;
+	struct searchWorkspace *ws = networkSearch(net, engine);
+	int numSettled = dijkstra(pug, ws, &sourceComputer, 1, INFINITY, numComputers, NULL);
+
+	struct linkAnalysis analysis = {pug, sourceComputer, ws, numSettled, NULL, 0, 0};
+	analysis.numLinks = linkCandidates(pug, ws, numSettled, sourceComputer, &analysis.impacts);
+	runLinkAnalysis(net, &analysis);
+	searchWorkspaceReset(ws);
+
+	// a candidate can turn out to have an equally fast way around it
+	int n = 0;
+	for (int i = 0; i < analysis.numLinks; i++) {
+		if (analysis.impacts[i].makespanDelta != 0 || analysis.impacts[i].reachedDelta != 0) {
+			analysis.impacts[n++] = analysis.impacts[i];
+		}
+	}
+	qsort(analysis.impacts, n, sizeof(struct linkImpact), compareImpacts);
+
+	*numLinks = n;
+	return analysis.impacts;
+}
+
 ////////////////////////////////////////////////////////////////////////
 // Task 4
 
@@ -181,197 +786,1572 @@ struct poodleResult advancedPoodle(
 	struct connection connections[], int numConnections,
 	int sourceComputer
 ) {
-	struct poodleResult res = {0, NULL};
+	PoodleNetwork net = PoodleNetworkNew(computers, numComputers, connections, numConnections);
+	struct poodleResult res = PoodleNetworkAdvancedPoodle(net, sourceComputer);
+	PoodleNetworkFree(net);
 
 	return res;
 }
 
-///////////////////////////////////////////////////// STAGE 1 HELPER FUNCTIONS ///////////////////////////////////////////////
-// a helper function that finds the most amount of (downstream) connections for a specified computer
-static int connected(Graph pug, int start, bool visited[], int can_visit[], int *count) {
-	Queue q = QueueNew();
-	QueueEnqueue(q, start);
-
-	visited[start] = true;
-	can_visit[(*count)++] = start;
-
-	while (QueueSize(q) > 0) {
-		int v = QueueDequeue(q);
-		int *adjacent = GraphNeighbours(pug, v);
-		int numAdjacent = GraphNeighbourCount(pug, v);
-
-		for (int i = 0; i < numAdjacent; i++) {
-			int neighbour = adjacent[i];
+struct poodleResult PoodleNetworkAdvancedPoodle(
+	PoodleNetwork net, int sourceComputer
+) {
+	struct poodleResult res = {0, NULL};
 
-			if (visited[neighbour] == false && (GraphGetSecurityLevel(pug, v) + 1 >= GraphGetSecurityLevel(pug, neighbour))) {
-				QueueEnqueue(q, neighbour);
-				visited[neighbour] = true;
-				can_visit[(*count)++] = neighbour;
-			}
-		}
+	return res;
+}
 
-		free(adjacent);
+//////////////////////////////////////////////////// NETWORK HELPER FUNCTIONS //////////////////////////////////////////////
+// a helper function that returns the number of threads parallel queries on a network should use
+static int threadCount(PoodleNetwork net) {
+	if (net->numThreads > 0) {
+		return net->numThreads;
 	}
 
-	QueueFree(q);
-
-	return *count;
+	long online = sysconf(_SC_NPROCESSORS_ONLN);
+	return online > 0 ? online : 1;
 }
 
-// a helper function that creates the graph
-static void CreateGraph(Graph g, int numComputers, int numConnections, struct connection connections[], struct computer computers[]) {
-	for (int i = 0; i < numComputers; i++) {
-		GraphSetVertexInfo(g, i, computers[i].securityLevel, computers[i].poodleTime);
+// a helper function that returns the network's task 3 workspace, creating it (or recreating it, if the
+// engine has changed) as needed
+static struct searchWorkspace *networkSearch(PoodleNetwork net, Engine engine) {
+	if (net->search != NULL && net->search->engine != engine) {
+		searchWorkspaceFree(net->search);
+		net->search = NULL;
 	}
-
-	for (int j = 0; j < numConnections; j++) {
-		GraphInsertEdge(g, connections[j].computerA, connections[j].computerB, connections[j].transmissionTime);
+	if (net->search == NULL) {
+		net->search = searchWorkspaceNew(net->pug, engine);
 	}
+
+	return net->search;
 }
 
-//////////////////////////////////////////////// STAGE 2 HELPER FUNCTIONS /////////////////////////////////////////////////////
-// a helper function that does an insertion sort
-static void insertionSort(int array[], int n) {
-	for (int i = 1; i < n; i++) {
-		int key = array[i];
-		int j = i - 1;
+///////////////////////////////////////////////////// STAGE 1 HELPER FUNCTIONS ///////////////////////////////////////////////
+// a helper function that creates a reachability workspace for a graph with numVert vertices
+static struct bfsWorkspace *bfsWorkspaceNew(int numVert) {
+	struct bfsWorkspace *ws = malloc(sizeof(struct bfsWorkspace));
+	if (ws == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
 
-		while (j >= 0 && array[j] > key) {
-			array[j + 1] = array[j];
-			j = j - 1;
-		}
+	ws->numVert = numVert;
+	ws->epoch = 0;
+	ws->mark = calloc(numVert, sizeof(unsigned int));
+	ws->level = malloc(numVert * sizeof(int));
+	ws->reached = calloc((numVert + 63) / 64, sizeof(uint64_t));
+	ws->q = QueueNewWithCapacity(numVert);
 
-		array[j + 1] = key;
+	if (numVert > 0 && (ws->mark == NULL || ws->level == NULL || ws->reached == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
 	}
+
+	return ws;
 }
 
-////////////////////////////////////////////// STAGE 3 HELPER FUNCTIONS //////////////////////////////////////////////////////
-// a helper function that performs djsktra's alogrithm 
-// initial idea from https://www.geeksforgeeks.org/dijkstras-shortest-path-algorithm-greedy-algo-7/ 
-// original lines of code that have been modified are marked with comments (9 lines of code)
-static void dijkstra(Graph g, int src, int dist[], bool sptSet[], struct computer computers[]) {
-	int numVert = GraphNumVertices(g);
-	Pq pq = PqNew();
-	
-	for (int i = 0; i < numVert; i++) { 														// Initialize all distances as INFINITE and stpSet[] as false
-		dist[i] = INT_MAX;
-		sptSet[i] = false;
-		PqInsert(pq, i, INT_MAX);
+// a helper function that frees a reachability workspace
+static void bfsWorkspaceFree(struct bfsWorkspace *ws) {
+	QueueFree(ws->q);
+	free(ws->mark);
+	free(ws->level);
+	free(ws->reached);
+	free(ws);
+}
+
+// a helper function that finds the most amount of (downstream) connections for a specified computer.
+// if reachable is not NULL, the computers found are written to it in ascending order.
+// each level is expanded either top-down (frontier computers send to their neighbours) or, when the
+// frontier is large, bottom-up (every unvisited computer looks for a frontier computer that may send to it)
+static int connected(Graph pug, struct bfsWorkspace *ws, int start, int reachable[]) {
+	ws->epoch++;
+	if (ws->epoch == 0) {														// the stamps wrapped around, so old marks could collide
+		memset(ws->mark, 0, ws->numVert * sizeof(unsigned int));
+		ws->epoch = 1;
 	}
 
-	dist[src] = computers[src].poodleTime;														// The output array. Distance of source vertex from itself is always poodleTime
+	int numVert = ws->numVert;
+	Queue q = ws->q;															// always holds exactly the current frontier
+	QueueEnqueue(q, start);
 
-	PqUpdate(pq, src, computers[src].poodleTime);																						 
+	ws->mark[start] = ws->epoch;
+	ws->level[start] = 0;
+	int count = 1;
+	if (reachable != NULL) {
+		ws->reached[start / 64] |= (uint64_t)1 << (start % 64);
+	}
 
-	while (PqSize(pq) > 0) {																	// Find shortest path for all vertices
-		int v = PqDelete(pq);																	// Pick the minimum distance vertex from the set of vertices not yet processed. v is always equal to src in the first iteration.
-		
-		if (sptSet[v] == true) {																// sptSet[i] will be true if vertex i is included in shortest path tree or shortest distance from src to i is finalized
-			continue;
-		}
+	int frontierEdges = GraphGetOutArcs(pug, start).count;
+	int unexploredEdges = GraphNumArcs(pug) - frontierEdges;
+	bool bottomUp = false;
 
-		sptSet[v] = true; 																		// Mark the picked vertex as processed
-		int *adjacent = GraphNeighbours(g, v);
-		int numAdjacent = GraphNeighbourCount(g, v);
+	for (int depth = 0; QueueSize(q) > 0; depth++) {
+		int frontierSize = QueueSize(q);
 
-		for (int i = 0; i < numAdjacent; i++) {													// Update dist value of the adjacent vertices of the picked vertex.
-			int u = adjacent[i];
-			int transmissionTime = GraphGetTransmissionTime(g, v, u);
+		if (bottomUp) {
+			bottomUp = frontierSize >= numVert / BFS_BETA;
+		} else {
+			bottomUp = frontierEdges > unexploredEdges / BFS_ALPHA;
+		}
+		frontierEdges = 0;
 
-			if ((computers[u].securityLevel <= computers[v].securityLevel + 1)) {				
-				int overflowTimeCheck = INT_MAX - transmissionTime - computers[u].poodleTime;
+		if (bottomUp) {
+			for (int i = 0; i < frontierSize; i++) {
+				QueueDequeue(q);
+			}
 
-				if (dist[v] != INT_MAX && dist[v] <= overflowTimeCheck) {
-					int distNext = dist[v] + transmissionTime + computers[u].poodleTime;
+			for (int w = 0; w < numVert; w++) {
+				if (ws->mark[w] == ws->epoch) {
+					continue;
+				}
 
-					if (distNext < dist[u]) {													// Update dist[u] only if is not in sptSet, there is an edge from u to v, 
-						dist[u] = distNext;														// and total weight of path from  src to u through v is smaller than current value of dist[u]
-						PqUpdate(pq, u, distNext);
+				GraphArcSpan senders = GraphGetInArcs(pug, w);
+
+				for (int i = 0; i < senders.count; i++) {
+					int u = senders.vertices[i];
+
+					if (ws->mark[u] == ws->epoch && ws->level[u] == depth) {
+						QueueEnqueue(q, w);
+						ws->mark[w] = ws->epoch;
+						ws->level[w] = depth + 1;
+						count++;
+						frontierEdges += GraphGetOutArcs(pug, w).count;
+						if (reachable != NULL) {
+							ws->reached[w / 64] |= (uint64_t)1 << (w % 64);
+						}
+						break;
+					}
+				}
+			}
+		} else {
+			for (int f = 0; f < frontierSize; f++) {
+				int v = QueueDequeue(q);
+				GraphArcSpan recipients = GraphGetOutArcs(pug, v);
+
+				for (int i = 0; i < recipients.count; i++) {
+					int neighbour = recipients.vertices[i];
+
+					if (ws->mark[neighbour] != ws->epoch) {
+						QueueEnqueue(q, neighbour);
+						ws->mark[neighbour] = ws->epoch;
+						ws->level[neighbour] = depth + 1;
+						count++;
+						frontierEdges += GraphGetOutArcs(pug, neighbour).count;
+						if (reachable != NULL) {
+							ws->reached[neighbour / 64] |= (uint64_t)1 << (neighbour % 64);
+						}
 					}
-				} 
+				}
 			}
 		}
 
-		free(adjacent);
+		unexploredEdges -= frontierEdges;
 	}
-	
-	PqFree(pq);
+
+	if (reachable != NULL) {
+		// list the set bits in order, clearing the bitmap for the next search
+		int k = 0;
+		for (int word = 0; word < (numVert + 63) / 64; word++) {
+			uint64_t bits = ws->reached[word];
+			while (bits != 0) {
+				reachable[k++] = word * 64 + __builtin_ctzll(bits);
+				bits &= bits - 1;
+			}
+			ws->reached[word] = 0;
+		}
+	}
+
+	return count;
 }
 
-// a helper function that constructs poodleResult from the distance array 
-static struct poodleResult returnResult(Graph g, int dist[], int numComputers, struct computer computers[]) {
-	struct poodleResult res = {0, NULL};
-	res.steps = malloc(numComputers * sizeof(struct step));
+// a helper function that creates the graph
+static Graph CreateGraph(int numComputers, int numConnections, struct connection connections[], struct computer computers[]) {
+	return GraphBuild(numComputers, computers, connections, numConnections);
+}
 
-	if (res.steps == NULL) {
-		fprintf(stderr, "Error: Out of memory");
+//////////////////////////////////////////////// STAGE 2 HELPER FUNCTIONS /////////////////////////////////////////////////////
+// a helper function that labels the strongly connected components of the graph's arcs (v -> w when
+// v may send to w), using an iterative version of tarjan's algorithm. returns the number of components
+static int stronglyConnected(Graph pug, int component[]) {
+	int numVert = GraphNumVertices(pug);
+	int *order = malloc(numVert * sizeof(int));			// order in which each vertex was discovered, or -1
+	int *low = malloc(numVert * sizeof(int));			// lowest discovery order reachable through the dfs subtree
+	int *nextEdge = malloc(numVert * sizeof(int));		// position in the arc span to resume from
+	int *callStack = malloc(numVert * sizeof(int));
+	int *sccStack = malloc(numVert * sizeof(int));
+	bool *onStack = calloc(numVert, sizeof(bool));
+
+	if (numVert > 0 && (order == NULL || low == NULL || nextEdge == NULL || callStack == NULL || sccStack == NULL || onStack == NULL)) {
+		fprintf(stderr, "Error: out of memory");
 		exit(1);
 	}
 
-	int count = 0;
-	for (int i = 0; i < numComputers; i++) {
+	for (int v = 0; v < numVert; v++) {
+		order[v] = -1;
+	}
+
+	int counter = 0;
+	int numComponents = 0;
+	int sccTop = 0;
 
-		if (dist[i] != INT_MAX) {
-			res.steps[count].computer = i;
-			res.steps[count].time = dist[i];
-			res.steps[count].recipients = createRecipientList(g, i, dist, computers);
-			count++;
+	for (int root = 0; root < numVert; root++) {
+		if (order[root] != -1) {
+			continue;
 		}
-	}
 
-	qsort(res.steps, count, sizeof(struct step), compareSteps);
-	res.numSteps = count;
+		int callTop = 0;
+		callStack[callTop++] = root;
+		order[root] = low[root] = counter++;
+		nextEdge[root] = 0;
+		sccStack[sccTop++] = root;
+		onStack[root] = true;
+
+		while (callTop > 0) {
+			int v = callStack[callTop - 1];
+			GraphArcSpan arcs = GraphGetOutArcs(pug, v);
+
+			if (nextEdge[v] < arcs.count) {
+				int w = arcs.vertices[nextEdge[v]++];
+
+				if (order[w] == -1) {
+					order[w] = low[w] = counter++;
+					nextEdge[w] = 0;
+					sccStack[sccTop++] = w;
+					onStack[w] = true;
+					callStack[callTop++] = w;
+				} else if (onStack[w] && order[w] < low[v]) {
+					low[v] = order[w];
+				}
+				continue;
+			}
+
+			// all of v's arcs are done, so pop it and pass its low link to its parent
+			callTop--;
+			if (callTop > 0) {
+				int parent = callStack[callTop - 1];
+				if (low[v] < low[parent]) {
+					low[parent] = low[v];
+				}
+			}
 
-	return res;
-}
+			if (low[v] == order[v]) {
+				int w;
+				do {
+					w = sccStack[--sccTop];
+					onStack[w] = false;
+					component[w] = numComponents;
+				} while (w != v);
+				numComponents++;
+			}
+		}
+	}
 
-// a helper function that compares the steps for qsort
-static int compareSteps(const void *a, const void *b) {
-	struct step *stepA = (struct step *)a;
-	struct step *stepB = (struct step *)b;
+	free(order);
+	free(low);
+	free(nextEdge);
+	free(callStack);
+	free(sccStack);
+	free(onStack);
 
-	return (stepA->time - stepB->time);
+	return numComponents;
 }
 
-// a helper function that creates the linked list of recipients for a given computer
-static struct computerList *createRecipientList(Graph g, int computer, int dist[], struct computer computers[]) {
-	struct computerList *head = NULL;
-	int *adjacent = GraphNeighbours(g, computer);
-	int numAdjacent = GraphNeighbourCount(g, computer);
+// a helper function that marks the lowest numbered computer of every source component, i.e. every strongly
+// connected component that no computer outside it can send to. only these computers can reach the most computers
+static bool *sourceRepresentatives(Graph pug) {
+	int numVert = GraphNumVertices(pug);
+	int *component = malloc(numVert * sizeof(int));
+	bool *candidate = calloc(numVert, sizeof(bool));
 
-	for (int i = 0; i < numAdjacent; i++) {
-		int x = adjacent[i];
-		int transmissionTime = GraphGetTransmissionTime(g, computer, x);
-		int distNext = dist[computer] + transmissionTime + computers[x].poodleTime;
+	if (numVert > 0 && (component == NULL || candidate == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
 
-		if (dist[x] == distNext && computers[x].securityLevel <= computers[computer].securityLevel + 1) {
-			struct computerList *newNode = malloc(sizeof(struct computerList));
-			 
-			if (newNode == NULL) {
-				fprintf(stderr, "Error: out of memory");
-				exit(1);
-			}
+	int numComponents = stronglyConnected(pug, component);
+	bool *hasIncoming = calloc(numComponents, sizeof(bool));
+	bool *represented = calloc(numComponents, sizeof(bool));
+
+	if (numComponents > 0 && (hasIncoming == NULL || represented == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
 
-			newNode->computer = x;
-			newNode->next = NULL;
-			
-			if (head == NULL || head->computer > newNode->computer) {
-				newNode->next = head;
-				head = newNode;
-			} else {
-				struct computerList *current = head;
+	for (int v = 0; v < numVert; v++) {
+		GraphArcSpan arcs = GraphGetOutArcs(pug, v);
 
-				while (current->next != NULL && current->next->computer < newNode->computer) {
-					current = current->next;
-				}
+		for (int i = 0; i < arcs.count; i++) {
+			int w = arcs.vertices[i];
 
-				newNode->next = current->next;
-				current->next = newNode;
+			if (component[w] != component[v]) {
+				hasIncoming[component[w]] = true;
 			}
 		}
 	}
 
-	free(adjacent);
+	for (int v = 0; v < numVert; v++) {
+		if (hasIncoming[component[v]] == false && represented[component[v]] == false) {
+			represented[component[v]] = true;
+			candidate[v] = true;
+		}
+	}
+
+	free(component);
+	free(hasIncoming);
+	free(represented);
+
+	return candidate;
+}
+
+// a helper function that lists the arcs out of each of computers (which are in ascending order), sorted by
+// where they go, setting numArcs to how many there are
+static ReachArc *arcsOut(Graph g, int computers[], int numComputers, int *numArcs) {
+	int n = 0;
+	for (int i = 0; i < numComputers; i++) {
+		n += GraphGetOutArcs(g, computers[i]).count;
+	}
 
-	return head;
-}
\ No newline at end of file
+	ReachArc *arcs = malloc(n * sizeof(ReachArc));
+	if (n > 0 && arcs == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	n = 0;
+	for (int i = 0; i < numComputers; i++) {
+		GraphArcSpan span = GraphGetOutArcs(g, computers[i]);
+		for (int k = 0; k < span.count; k++) {
+			arcs[n].from = computers[i];
+			arcs[n++].to = span.vertices[k];
+		}
+	}
+	qsort(arcs, n, sizeof(ReachArc), compareArcs);
+
+	*numArcs = n;
+	return arcs;
+}
+
+// a helper function that tells a reachability index which arcs a batch of changes added and removed, by
+// comparing the arcs out of computers now with oldArcs, those from before the batch (as arcsOut lists them).
+// computers has to include every computer whose arcs out the batch may have changed
+static void updateReachIndex(ReachIndex ri, Graph g, int computers[], int numComputers, ReachArc oldArcs[], int numOld) {
+	int numNew = 0;
+	ReachArc *newArcs = arcsOut(g, computers, numComputers, &numNew);
+	ReachArc *removed = malloc(numOld * sizeof(ReachArc));
+	ReachArc *added = malloc(numNew * sizeof(ReachArc));
+	if ((numOld > 0 && removed == NULL) || (numNew > 0 && added == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	int numRemoved = 0;
+	int numAdded = 0;
+	int i = 0;
+	int k = 0;
+	while (i < numOld || k < numNew) {
+		int cmp = i == numOld ? 1 : k == numNew ? -1 : compareArcs(&oldArcs[i], &newArcs[k]);
+		if (cmp == 0) {
+			i++;
+			k++;
+		} else if (cmp < 0) {
+			removed[numRemoved++] = oldArcs[i++];
+		} else {
+			added[numAdded++] = newArcs[k++];
+		}
+	}
+
+	ReachIndexUpdate(ri, removed, numRemoved, added, numAdded);
+
+	free(newArcs);
+	free(removed);
+	free(added);
+}
+
+// a helper function that compares arcs for qsort, by where they come from and then where they go
+static int compareArcs(const void *a, const void *b) {
+	ReachArc *arcA = (ReachArc *)a;
+	ReachArc *arcB = (ReachArc *)b;
+
+	if (arcA->from != arcB->from) {
+		return compareComputers(&arcA->from, &arcB->from);
+	}
+	return compareComputers(&arcA->to, &arcB->to);
+}
+
+////////////////////////////////////////////// STAGE 3 HELPER FUNCTIONS //////////////////////////////////////////////////////
+// a helper function that marks every computer that reaches the most computers, returning how many that is.
+// these are the computers of the source components whose lowest computer chooseSource would consider best
+static int maxReachCandidates(PoodleNetwork net, bool candidate[]) {
+	Graph pug = net->pug;
+	int numComputers = GraphNumVertices(pug);
+
+	bool *representative = sourceRepresentatives(pug);
+	int *component = malloc(numComputers * sizeof(int));
+	int *sources = malloc(numComputers * sizeof(int));
+	int *counts = malloc(numComputers * sizeof(int));
+	if (numComputers > 0 && (component == NULL || sources == NULL || counts == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	int numComponents = stronglyConnected(pug, component);
+	bool *best = calloc(numComponents, sizeof(bool));
+	if (numComponents > 0 && best == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	int numSources = 0;
+	for (int v = 0; v < numComputers; v++) {
+		if (representative[v]) {
+			sources[numSources++] = v;
+		}
+	}
+	PoodleNetworkReachableCounts(net, sources, numSources, counts);
+
+	int maxCount = 0;
+	for (int i = 0; i < numSources; i++) {
+		if (counts[i] > maxCount) {
+			maxCount = counts[i];
+		}
+	}
+	for (int i = 0; i < numSources; i++) {
+		if (counts[i] == maxCount) {
+			best[component[sources[i]]] = true;
+		}
+	}
+	for (int v = 0; v < numComputers; v++) {
+		candidate[v] = best[component[v]];
+	}
+
+	free(representative);
+	free(component);
+	free(sources);
+	free(counts);
+	free(best);
+
+	return maxCount;
+}
+
+// a helper function that creates a workspace for task 3 searches on g with the given engine
+static struct searchWorkspace *searchWorkspaceNew(Graph g, Engine engine) {
+	int numVert = GraphNumVertices(g);
+	struct searchWorkspace *ws = malloc(sizeof(struct searchWorkspace));
+	if (ws == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	ws->engine = engine;
+	ws->pq = frontierNew(g, engine);
+	ws->dist = malloc(numVert * sizeof(int));
+	ws->sptSet = calloc(numVert, sizeof(bool));
+	ws->dag = sendersNew(g);
+	ws->order = malloc(numVert * sizeof(int));
+	ws->position = malloc(numVert * sizeof(int));
+	ws->reached = malloc(numVert * sizeof(int));
+	ws->numReached = 0;
+
+	if (numVert > 0 && (ws->dist == NULL || ws->sptSet == NULL || ws->order == NULL || ws->position == NULL
+		|| ws->reached == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	for (int v = 0; v < numVert; v++) {
+		ws->dist[v] = INT_MAX;
+	}
+
+	return ws;
+}
+
+// a helper function that frees a task 3 workspace
+static void searchWorkspaceFree(struct searchWorkspace *ws) {
+	frontierFree(&ws->pq);
+	sendersFree(&ws->dag);
+	free(ws->dist);
+	free(ws->sptSet);
+	free(ws->order);
+	free(ws->position);
+	free(ws->reached);
+	free(ws);
+}
+
+// a helper function that cleans up after a search, touching only the computers it reached
+static void searchWorkspaceReset(struct searchWorkspace *ws) {
+	for (int i = 0; i < ws->numReached; i++) {
+		int v = ws->reached[i];
+		ws->dist[v] = INT_MAX;
+		ws->sptSet[v] = false;
+		ws->dag.first[v] = -1;
+	}
+	ws->numReached = 0;
+	ws->dag.size = 0;
+}
+
+// a helper function that performs djsktra's alogrithm 
+// initial idea from https://www.geeksforgeeks.org/dijkstras-shortest-path-algorithm-greedy-algo-7/ 
+// original lines of code that have been modified are marked with comments (9 lines of code)
+// the search runs in a workspace, which is left with the times, the computers settled in the order of the
+// plan (once each run of equal times is sorted by computer) and the senders of every computer reached.
+// it stops before settling a computer poodled after deadline, and once maxSteps computers have been
+// settled along with any others poodled at the same time as the last of them. returns the number of
+// computers settled. if stream is not NULL each step is passed to its callback once its recipients are known.
+// the sources (sorted by poodle time, without repeats, as sortSources leaves them) are all poodled at once,
+// each at its own poodle time unless the pug reaches it sooner
+static int dijkstra(Graph g, struct searchWorkspace *ws, int sources[], int numSources, int deadline, int maxSteps, struct stepStream *stream) {
+	int *dist = ws->dist;																		// every dist starts as INFINITE and every sptSet as false
+	bool *sptSet = ws->sptSet;
+	int *order = ws->order;
+	struct frontier *pq = &ws->pq;
+	int maxCost = GraphMaxArcCost(g);
+
+	int numSettled = 0;
+	int runStart = 0;																			// the first computer settled at the current time
+	int nextSource = 0;																			// the first source not yet queued
+	int lastTime = 0;																			// the time of the last computer settled
+
+	while (frontierSize(pq) > 0 || nextSource < numSources) {									// Find shortest path for all vertices
+		// a source is queued once something in the queue could be poodled after it. everything queued is
+		// within maxCost of the last computer settled, so the times in the queue stay within maxCost of
+		// each other, as the bucket queue needs. a source queued once the queue has run dry may be
+		// further ahead than that, so the queue is cleared first to let it start again from any time
+		while (nextSource < numSources && (frontierSize(pq) == 0
+			|| GraphGetPoodleTime(g, sources[nextSource]) <= (long long)lastTime + maxCost)) {
+			if (frontierSize(pq) == 0) {
+				frontierClear(pq);
+			}
+			int src = sources[nextSource++];
+			int poodleTime = GraphGetPoodleTime(g, src);										// Distance of source vertex from itself is always poodleTime
+
+			if (poodleTime == INFINITY) {														// a computer that is never poodled has no place in the plan
+				continue;
+			}
+			if (poodleTime < dist[src]) {
+				if (dist[src] == INT_MAX) {
+					ws->reached[ws->numReached++] = src;
+				}
+				dist[src] = poodleTime;
+				frontierPush(pq, src, poodleTime);											// Vertices only enter the queue once they are first reached
+				ws->dag.first[src] = -1;
+			}
+		}
+		if (frontierSize(pq) == 0) {															// every source left was never poodled
+			break;
+		}
+
+		int v = frontierPop(pq);																	// Pick the minimum distance vertex from the set of vertices not yet processed. v is always a source in the first iteration.
+		
+		if (sptSet[v] == true) {																// sptSet[i] will be true if vertex i is included in shortest path tree or shortest distance from src to i is finalized
+			continue;
+		}
+
+		if (dist[v] > deadline || (numSettled >= maxSteps && (numSettled == 0 || dist[v] != dist[order[numSettled - 1]]))) {
+			break;
+		}
+
+		if (numSettled > 0 && dist[v] != dist[order[runStart]]) {								// every computer of the previous time has been settled, so put them in order
+			sortRun(order, runStart, numSettled);
+			runStart = numSettled;
+		}
+		if (stream != NULL) {
+			streamSteps(g, dist, order, numSettled, dist[v], stream);
+		}
+
+		sptSet[v] = true; 																		// Mark the picked vertex as processed
+		order[numSettled++] = v;
+		lastTime = dist[v];
+		GraphArcSpan arcs = GraphGetOutArcs(g, v);												// the arcs already skip computers v may not send to
+
+		for (int i = 0; i < arcs.count; i++) {													// Update dist value of the adjacent vertices of the picked vertex.
+			int u = arcs.vertices[i];
+			int cost = arcs.costs[i];															// transmission time plus the poodle time of u
+
+			if (dist[v] < INT_MAX - cost) {
+				int distNext = dist[v] + cost;
+
+				if (distNext < dist[u]) {														// Update dist[u] only if is not in sptSet, there is an edge from u to v, 
+					if (dist[u] == INT_MAX) {
+						ws->reached[ws->numReached++] = u;
+					}
+					dist[u] = distNext;															// and total weight of path from  src to u through v is smaller than current value of dist[u]
+					frontierPush(pq, u, distNext);
+					ws->dag.first[u] = -1;														// the senders recorded so far are no longer on a shortest path
+				}
+
+				if (distNext == dist[u]) {
+					sendersAdd(&ws->dag, u, v);
+				}
+			}
+		}
+	}
+
+	sortRun(order, runStart, numSettled);
+	if (stream != NULL) {
+		streamSteps(g, dist, order, numSettled, LLONG_MAX, stream);
+	}
+	
+	frontierClear(pq);																			// a bounded search can stop with computers still queued
+
+	return numSettled;
+}
+
+// a helper function that sorts order[first] up to order[last], a run of computers settled at the same time,
+// so that ties are always broken by computer number
+static void sortRun(int order[], int first, int last) {
+	for (int i = first + 1; i < last; i++) {
+		if (order[i - 1] > order[i]) {
+			qsort(&order[first], last - first, sizeof(int), compareComputers);
+			return;
+		}
+	}
+}
+
+// a helper function that checks whether u, at the end of an arc from v of the given cost, is a recipient of v
+static bool isRecipient(int dist[], int v, int u, int cost) {
+	return dist[u] != INT_MAX && dist[u] == (long long)dist[v] + cost;
+}
+
+// a helper function that passes the held back steps of a stream to its callback, in order, for as long as
+// the next one's recipients are known: once the search has reached time, every computer whose time is
+// below it has been settled, so a step is done once each of its arcs leads below time
+static void streamSteps(Graph g, int dist[], int order[], int numSettled, long long time, struct stepStream *stream) {
+	while (stream->emitted < numSettled) {
+		int v = order[stream->emitted];
+		GraphArcSpan arcs = GraphGetOutArcs(g, v);
+
+		int numRecipients = 0;
+		for (int i = 0; i < arcs.count; i++) {
+			if ((long long)dist[v] + arcs.costs[i] >= time) {
+				return;
+			}
+			if (isRecipient(dist, v, arcs.vertices[i], arcs.costs[i])) {
+				numRecipients++;
+			}
+		}
+
+		if (numRecipients > stream->capacity) {
+			stream->capacity = numRecipients;
+			stream->recipients = realloc(stream->recipients, stream->capacity * sizeof(int));
+			stream->nodes = realloc(stream->nodes, stream->capacity * sizeof(struct computerList));
+			if (stream->recipients == NULL || stream->nodes == NULL) {
+				fprintf(stderr, "Error: out of memory");
+				exit(1);
+			}
+		}
+
+		int k = 0;
+		for (int i = 0; i < arcs.count; i++) {
+			if (isRecipient(dist, v, arcs.vertices[i], arcs.costs[i])) {
+				stream->recipients[k++] = arcs.vertices[i];
+			}
+		}
+		if (numRecipients > 1) {
+			qsort(stream->recipients, numRecipients, sizeof(int), compareComputers);
+		}
+
+		struct step step = {v, dist[v], NULL};
+		for (k = numRecipients - 1; k >= 0; k--) {
+			stream->nodes[k].computer = stream->recipients[k];
+			stream->nodes[k].next = step.recipients;
+			step.recipients = &stream->nodes[k];
+		}
+
+		stream->emitted++;
+		stream->callback(step, stream->context);
+	}
+}
+
+// a helper function that creates the queue for dijkstra, using a bucket queue if asked for (or left to
+// ENGINE_AUTO) and the step costs are small enough, and the heap otherwise
+static struct frontier frontierNew(Graph g, Engine engine) {
+	struct frontier f = {ENGINE_HEAP, NULL, NULL};
+	int numVert = GraphNumVertices(g);
+
+	if (engine == ENGINE_AUTO || engine == ENGINE_BUCKET) {
+		int maxCost = GraphMaxArcCost(g);
+		if (maxCost <= BUCKET_QUEUE_MAX_STEP
+			&& (engine == ENGINE_BUCKET || (long long)maxCost <= (long long)BUCKET_QUEUE_AUTO_RATIO * numVert)) {
+			f.engine = ENGINE_BUCKET;
+			f.bq = BucketQueueNew(numVert, maxCost);
+			return f;
+		}
+	}
+
+	f.pq = PqNewWithCapacity(numVert);
+	return f;
+}
+
+// a helper function that frees the queue for dijkstra
+static void frontierFree(struct frontier *f) {
+	if (f->engine == ENGINE_BUCKET) {
+		BucketQueueFree(f->bq);
+	} else {
+		PqFree(f->pq);
+	}
+}
+
+// a helper function that adds a computer to the queue, or lowers its time if it is already there
+static void frontierPush(struct frontier *f, int v, int time) {
+	if (f->engine == ENGINE_BUCKET) {
+		if (BucketQueueContains(f->bq, v)) {
+			BucketQueueUpdate(f->bq, v, time);
+		} else {
+			BucketQueueInsert(f->bq, v, time);
+		}
+	} else {
+		if (PqContains(f->pq, v)) {
+			PqUpdate(f->pq, v, time);
+		} else {
+			PqInsert(f->pq, v, time);
+		}
+	}
+}
+
+// a helper function that removes a computer with the smallest time from the queue
+static int frontierPop(struct frontier *f) {
+	if (f->engine == ENGINE_BUCKET) {
+		return BucketQueueDelete(f->bq);
+	}
+	return PqDelete(f->pq);
+}
+
+// a helper function that returns the number of computers in the queue
+static int frontierSize(struct frontier *f) {
+	if (f->engine == ENGINE_BUCKET) {
+		return BucketQueueSize(f->bq);
+	}
+	return PqSize(f->pq);
+}
+
+// a helper function that removes every computer from the queue
+static void frontierClear(struct frontier *f) {
+	if (f->engine == ENGINE_BUCKET) {
+		BucketQueueClear(f->bq);
+	} else {
+		while (PqSize(f->pq) > 0) {
+			PqDelete(f->pq);
+		}
+	}
+}
+
+// a helper function that creates an empty record of senders with room for one entry per arc of g
+static struct senders sendersNew(Graph g) {
+	int numVert = GraphNumVertices(g);
+	int numArcs = GraphNumArcs(g);
+	struct senders dag = {NULL, NULL, NULL, 0};
+
+	dag.first = malloc(numVert * sizeof(int));
+	dag.sender = malloc(numArcs * sizeof(int));
+	dag.next = malloc(numArcs * sizeof(int));
+
+	if ((numVert > 0 && dag.first == NULL) || (numArcs > 0 && (dag.sender == NULL || dag.next == NULL))) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	for (int v = 0; v < numVert; v++) {
+		dag.first[v] = -1;
+	}
+
+	return dag;
+}
+
+// a helper function that frees a record of senders
+static void sendersFree(struct senders *dag) {
+	free(dag->first);
+	free(dag->sender);
+	free(dag->next);
+}
+
+// a helper function that records that computer could have been sent the pug by sender
+static void sendersAdd(struct senders *dag, int computer, int sender) {
+	dag->sender[dag->size] = sender;
+	dag->next[dag->size] = dag->first[computer];
+	dag->first[computer] = dag->size++;
+}
+
+// a helper function that records the senders of every computer from finished times, for searches that
+// only produce times. uses the arcs into each computer
+static void sendersFromTimes(Graph g, int dist[], struct senders *dag) {
+	for (int u = 0; u < GraphNumVertices(g); u++) {
+		if (dist[u] == INT_MAX) {
+			continue;
+		}
+
+		GraphArcSpan arcs = GraphGetInArcs(g, u);
+		for (int i = 0; i < arcs.count; i++) {
+			int v = arcs.vertices[i];
+
+			if (dist[v] != INT_MAX && isRecipient(dist, v, u, arcs.costs[i])) {
+				sendersAdd(dag, u, v);
+			}
+		}
+	}
+}
+
+// a helper function that runs a task 3 search from sources (as dijkstra takes them) on a network, bounded as
+// in PoodleNetworkPoodleBounded, and lays its plan out flat
+static struct poodlePlan searchPlan(PoodleNetwork net, int sources[], int numSources, int deadline, int maxSteps) {
+	Graph pug = net->pug;
+	int numComputers = GraphNumVertices(pug);
+	bool bounded = deadline != INFINITY || maxSteps < numComputers;
+
+	// delta-stepping always solves the whole network from one source, so other searches stay on one thread
+	Engine engine = net->engine == ENGINE_PARALLEL && (bounded || numSources != 1) ? ENGINE_AUTO : net->engine;
+	struct searchWorkspace *ws = networkSearch(net, engine);
+	int numSettled = 0;
+
+	if (engine == ENGINE_PARALLEL) {
+		// delta-stepping settles a bucket of times at once rather than one time after another, so its
+		// computers still have to be sorted
+		DeltaStepping(pug, sources[0], ws->dist, threadCount(net));
+		for (int v = 0; v < numComputers; v++) {
+			if (ws->dist[v] != INT_MAX) {
+				ws->reached[ws->numReached++] = v;
+				ws->order[numSettled++] = v;
+				ws->sptSet[v] = true;
+			}
+		}
+		sendersFromTimes(pug, ws->dist, &ws->dag);
+		orderByTime(ws->order, numSettled, ws->dist);
+	} else {
+		numSettled = dijkstra(pug, ws, sources, numSources, deadline, maxSteps, NULL);
+	}
+
+	int numSteps = numSettled < maxSteps ? numSettled : maxSteps;
+	struct poodlePlan plan = createPlan(pug, ws, numSettled, numSteps);
+
+	searchWorkspaceReset(ws);
+
+	return plan;
+}
+
+// a helper function that copies sources into sorted in order of poodle time, leaving out repeats, for
+// dijkstra. returns the number of sources left
+static int sortSources(Graph g, int sources[], int numSources, int sorted[]) {
+	struct step *steps = malloc(numSources * sizeof(struct step));
+	if (numSources > 0 && steps == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	for (int i = 0; i < numSources; i++) {
+		assert(sources[i] >= 0 && sources[i] < GraphNumVertices(g));
+		steps[i].computer = sources[i];
+		steps[i].time = GraphGetPoodleTime(g, sources[i]);
+		steps[i].recipients = NULL;
+	}
+
+	qsort(steps, numSources, sizeof(struct step), compareSteps);
+
+	int numSorted = 0;
+	for (int i = 0; i < numSources; i++) {
+		if (numSorted == 0 || sorted[numSorted - 1] != steps[i].computer) {
+			sorted[numSorted++] = steps[i].computer;
+		}
+	}
+
+	free(steps);
+
+	return numSorted;
+}
+
+// a helper function that runs a batch of task 3 queries on up to one thread per source, the calling thread
+// being one of them and using the network's own workspace
+static void runBatch(PoodleNetwork net, struct poodleBatch *batch) {
+	int numThreads = threadCount(net) < batch->numSources ? threadCount(net) : batch->numSources;
+	if (numThreads == 0) {
+		return;
+	}
+
+	pthread_t *threads = malloc(numThreads * sizeof(pthread_t));
+	struct batchWorker *workers = malloc(numThreads * sizeof(struct batchWorker));
+	if (threads == NULL || workers == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	for (int t = 0; t < numThreads; t++) {
+		workers[t].batch = batch;
+		workers[t].ws = t == 0 ? networkSearch(net, batch->engine) : searchWorkspaceNew(net->pug, batch->engine);
+	}
+	for (int t = 1; t < numThreads; t++) {
+		if (pthread_create(&threads[t], NULL, batchWorker, &workers[t]) != 0) {
+			fprintf(stderr, "Error: failed to create thread");
+			exit(1);
+		}
+	}
+
+	batchWorker(&workers[0]);
+
+	for (int t = 1; t < numThreads; t++) {
+		pthread_join(threads[t], NULL);
+		searchWorkspaceFree(workers[t].ws);
+	}
+
+	free(threads);
+	free(workers);
+}
+
+// a helper function run by every thread of a batch: search from each source it claims, then clean up its
+// workspace for the next
+static void *batchWorker(void *arg) {
+	struct batchWorker *worker = arg;
+	struct poodleBatch *batch = worker->batch;
+	struct searchWorkspace *ws = worker->ws;
+	int numComputers = GraphNumVertices(batch->g);
+
+	while (true) {
+		int i = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+		if (i >= batch->numSources) {
+			break;
+		}
+
+		int numSettled = dijkstra(batch->g, ws, &batch->sources[i], 1, INFINITY, numComputers, NULL);
+
+		if (batch->results != NULL) {
+			struct poodlePlan plan = createPlan(batch->g, ws, numSettled, numSettled);
+			batch->results[i] = planToResult(plan, false);
+			PoodlePlanFree(plan);
+		} else {
+			batch->summaries[i].numSteps = numSettled;
+			batch->summaries[i].completionTime = numSettled > 0 ? ws->dist[ws->order[numSettled - 1]] : 0;
+		}
+
+		searchWorkspaceReset(ws);
+	}
+
+	return NULL;
+}
+
+// a helper function that creates a tracked plan from source, with every time INT_MAX
+static struct trackedPlan *trackedPlanNew(int numVert, int source) {
+	struct trackedPlan *tp = malloc(sizeof(struct trackedPlan));
+	if (tp == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	tp->source = source;
+	tp->dist = malloc(numVert * sizeof(int));
+	tp->lost = malloc(numVert * sizeof(int));
+	tp->invalid = calloc(numVert, sizeof(bool));
+	tp->pq = PqNewWithCapacity(numVert);
+
+	if (numVert > 0 && (tp->dist == NULL || tp->lost == NULL || tp->invalid == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	for (int v = 0; v < numVert; v++) {
+		tp->dist[v] = INT_MAX;
+	}
+
+	return tp;
+}
+
+// a helper function that frees a tracked plan
+static void trackedPlanFree(struct trackedPlan *tp) {
+	free(tp->dist);
+	free(tp->lost);
+	free(tp->invalid);
+	PqFree(tp->pq);
+	free(tp);
+}
+
+// a helper function that lists the computers whose arcs in or out a batch of changes may add, remove or change
+// the cost of, before the changes are made: both ends of a connection, and a changed computer along with its
+// neighbours (its security level decides which arcs it has both ways). any neighbour it gains in the batch is
+// the end of a connection, so is listed too. returns the list, in ascending order, and sets numHeads
+static int *changedHeads(Graph g, struct networkChange changes[], int numChanges, int *numHeads) {
+	int capacity = 1;
+	for (int i = 0; i < numChanges; i++) {
+		if (changes[i].kind == CHANGE_SET_COMPUTER) {
+			capacity += 1 + GraphNeighbourCount(g, changes[i].computer);
+		} else {
+			capacity += 2;
+		}
+	}
+
+	int *heads = malloc(capacity * sizeof(int));
+	if (heads == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	int n = 0;
+	for (int i = 0; i < numChanges; i++) {
+		if (changes[i].kind == CHANGE_SET_COMPUTER) {
+			GraphNeighbourSpan span = GraphGetNeighbours(g, changes[i].computer);
+			heads[n++] = changes[i].computer;
+			for (int k = 0; k < span.count; k++) {
+				heads[n++] = span.neighbours[k];
+			}
+		} else {
+			heads[n++] = changes[i].connection.computerA;
+			heads[n++] = changes[i].connection.computerB;
+		}
+	}
+
+	qsort(heads, n, sizeof(int), compareComputers);
+	int numDistinct = 0;
+	for (int i = 0; i < n; i++) {
+		if (numDistinct == 0 || heads[numDistinct - 1] != heads[i]) {
+			heads[numDistinct++] = heads[i];
+		}
+	}
+
+	*numHeads = numDistinct;
+	return heads;
+}
+
+// a helper function that brings a tracked plan up to date once its network has changed, where heads lists
+// every computer whose arcs in may have changed (as changedHeads gives them). the source is checked as well,
+// since its own poodle time may have changed. this is ramalingam and reps'
+// method for a batch of changes ("An Incremental Algorithm for a Generalization of the Shortest-Path
+// Problem", J. Algorithms 1996). the first phase finds the computers whose times may now be too early,
+// checking each in order of time so that every computer poodled before it has been checked first: starting
+// from the heads, and moving along the shortest path dag out of every computer whose time does not stand.
+// the second phase searches those computers again, along with any head a new or faster arc makes earlier,
+// starting from the times around them that still stand. nothing else is visited
+static void trackedPlanUpdate(Graph g, struct trackedPlan *tp, int heads[], int numHeads) {
+	int *dist = tp->dist;
+	Pq pq = tp->pq;
+	int numLost = 0;
+
+	for (int i = -1; i < numHeads; i++) {
+		int u = i == -1 ? tp->source : heads[i];
+		if (dist[u] != INT_MAX && !PqContains(pq, u)) {
+			PqInsert(pq, u, dist[u]);
+		}
+	}
+
+	while (PqSize(pq) > 0) {
+		int u = PqDelete(pq);
+		if (timeStands(g, tp, u)) {
+			continue;
+		}
+
+		tp->invalid[u] = true;
+		tp->lost[numLost++] = u;
+
+		GraphArcSpan arcs = GraphGetOutArcs(g, u);
+		for (int i = 0; i < arcs.count; i++) {
+			int w = arcs.vertices[i];
+			if (!tp->invalid[w] && isRecipient(dist, u, w, arcs.costs[i]) && !PqContains(pq, w)) {
+				PqInsert(pq, w, dist[w]);
+			}
+		}
+	}
+
+	for (int i = 0; i < numLost; i++) {
+		dist[tp->lost[i]] = INT_MAX;
+		tp->invalid[tp->lost[i]] = false;
+	}
+	reseed(g, tp, tp->source);
+	for (int i = 0; i < numHeads; i++) {
+		reseed(g, tp, heads[i]);
+	}
+	for (int i = 0; i < numLost; i++) {
+		reseed(g, tp, tp->lost[i]);
+	}
+
+	while (PqSize(pq) > 0) {
+		int v = PqDelete(pq);
+		GraphArcSpan arcs = GraphGetOutArcs(g, v);
+
+		for (int i = 0; i < arcs.count; i++) {
+			if (dist[v] < INT_MAX - arcs.costs[i] && dist[v] + arcs.costs[i] < dist[arcs.vertices[i]]) {
+				lowerTime(tp, arcs.vertices[i], dist[v] + arcs.costs[i]);
+			}
+		}
+	}
+}
+
+// a helper function that checks whether u's time in a tracked plan still stands after a change, i.e. is no
+// earlier than u can now be poodled. it does if u can be sent the pug by then by a computer whose time
+// stands and is strictly earlier (so a computer can never be kept by one it was sent the pug by). the
+// source's time stands as long as its poodle time is no later
+static bool timeStands(Graph g, struct trackedPlan *tp, int u) {
+	int *dist = tp->dist;
+	if (u == tp->source) {
+		return dist[u] >= GraphGetPoodleTime(g, u);
+	}
+
+	GraphArcSpan arcs = GraphGetInArcs(g, u);
+	for (int i = 0; i < arcs.count; i++) {
+		int v = arcs.vertices[i];
+		if (!tp->invalid[v] && dist[v] < dist[u] && (long long)dist[v] + arcs.costs[i] <= dist[u]) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// a helper function that lowers u's time in a tracked plan to the earliest any arc into it (or, for the
+// source, its own poodle time) gives, queueing it to be searched from if that is an improvement
+static void reseed(Graph g, struct trackedPlan *tp, int u) {
+	int *dist = tp->dist;
+	int best = u == tp->source ? GraphGetPoodleTime(g, u) : INT_MAX;
+
+	GraphArcSpan arcs = GraphGetInArcs(g, u);
+	for (int i = 0; i < arcs.count; i++) {
+		int v = arcs.vertices[i];
+		if (dist[v] < INT_MAX - arcs.costs[i] && dist[v] + arcs.costs[i] < best) {
+			best = dist[v] + arcs.costs[i];
+		}
+	}
+
+	if (best < dist[u]) {
+		lowerTime(tp, u, best);
+	}
+}
+
+// a helper function that sets u's time in a tracked plan to an earlier time, and queues it at that time
+static void lowerTime(struct trackedPlan *tp, int u, int time) {
+	tp->dist[u] = time;
+	if (PqContains(tp->pq, u)) {
+		PqUpdate(tp->pq, u, time);
+	} else {
+		PqInsert(tp->pq, u, time);
+	}
+}
+
+// a helper function that lists the connections whose loss may change a task 3 plan, from the search that found
+// it. losing a connection only matters to a computer it was the last way left for the pug to reach it from one
+// poodled strictly earlier: otherwise every computer keeps its time, as the earlier sender was reached without
+// the connection. so a connection is a candidate if it carries one end's only strictly earlier sender, or any
+// sender of an end with none. sets candidates to the list, with each connection once, and returns its length
+static int linkCandidates(Graph g, struct searchWorkspace *ws, int numSettled, int source, struct linkImpact **candidates) {
+	struct senders *dag = &ws->dag;
+	int *dist = ws->dist;
+
+	struct linkImpact *links = malloc((dag->size > 0 ? dag->size : 1) * sizeof(struct linkImpact));
+	if (links == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	int n = 0;
+	for (int i = 0; i < numSettled; i++) {
+		int u = ws->order[i];
+		if (u == source) {
+			continue;
+		}
+
+		int numEarlier = 0;
+		int earlier = -1;
+		for (int e = dag->first[u]; e != -1; e = dag->next[e]) {
+			if (dist[dag->sender[e]] < dist[u]) {
+				numEarlier++;
+				earlier = dag->sender[e];
+			}
+		}
+
+		for (int e = dag->first[u]; e != -1; e = dag->next[e]) {
+			int v = dag->sender[e];
+			if (numEarlier == 0 || (numEarlier == 1 && v == earlier)) {
+				links[n].connection.computerA = v < u ? v : u;
+				links[n].connection.computerB = v < u ? u : v;
+				links[n].connection.transmissionTime = GraphGetTransmissionTime(g, v, u);
+				n++;
+			}
+		}
+	}
+
+	qsort(links, n, sizeof(struct linkImpact), compareLinks);
+	int numDistinct = 0;
+	for (int i = 0; i < n; i++) {
+		if (numDistinct == 0 || compareLinks(&links[numDistinct - 1], &links[i]) != 0) {
+			links[numDistinct++] = links[i];
+		}
+	}
+
+	*candidates = links;
+	return numDistinct;
+}
+
+// a helper function that evaluates the candidates of a critical link analysis on up to one thread per
+// candidate, the calling thread being one of them
+static void runLinkAnalysis(PoodleNetwork net, struct linkAnalysis *analysis) {
+	int numThreads = threadCount(net) < analysis->numLinks ? threadCount(net) : analysis->numLinks;
+	if (numThreads == 0) {
+		return;
+	}
+
+	pthread_t *threads = malloc(numThreads * sizeof(pthread_t));
+	struct linkWorker *workers = malloc(numThreads * sizeof(struct linkWorker));
+	if (threads == NULL || workers == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	for (int t = 0; t < numThreads; t++) {
+		workers[t].analysis = analysis;
+	}
+	for (int t = 1; t < numThreads; t++) {
+		if (pthread_create(&threads[t], NULL, linkWorker, &workers[t]) != 0) {
+			fprintf(stderr, "Error: failed to create thread");
+			exit(1);
+		}
+	}
+
+	linkWorker(&workers[0]);
+
+	for (int t = 1; t < numThreads; t++) {
+		pthread_join(threads[t], NULL);
+	}
+
+	free(threads);
+	free(workers);
+}
+
+// a helper function run by every thread of a critical link analysis: evaluate each candidate it claims. its
+// scratch is clear between candidates (nothing lost, every time INT_MAX and the queue empty), so each only
+// costs as much as the part of the plan it affects
+static void *linkWorker(void *arg) {
+	struct linkWorker *worker = arg;
+	struct linkAnalysis *analysis = worker->analysis;
+	int numComputers = GraphNumVertices(analysis->g);
+
+	bool *lost = calloc(numComputers, sizeof(bool));
+	int *time = malloc(numComputers * sizeof(int));
+	int *lostList = malloc(numComputers * sizeof(int));
+	Pq pq = PqNewWithCapacity(numComputers);
+	if (numComputers > 0 && (lost == NULL || time == NULL || lostList == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+	for (int v = 0; v < numComputers; v++) {
+		time[v] = INT_MAX;
+	}
+
+	while (true) {
+		int i = __atomic_fetch_add(&analysis->next, 1, __ATOMIC_RELAXED);
+		if (i >= analysis->numLinks) {
+			break;
+		}
+
+		evaluateLink(analysis, lost, time, lostList, pq, &analysis->impacts[i]);
+	}
+
+	free(lost);
+	free(time);
+	free(lostList);
+	PqFree(pq);
+
+	return NULL;
+}
+
+// a helper function that works out what losing impact's connection would do to the plan, as a tracked plan
+// is updated but without changing the network. first the computers that lose their times are found, in order
+// of time, by following the shortest path dag out from the connection's ends: a computer keeps its time if
+// one that keeps its own sent it the pug strictly earlier. then only those are searched again, from the
+// computers that kept their times
+static void evaluateLink(struct linkAnalysis *analysis, bool lost[], int time[], int lostList[], Pq pq, struct linkImpact *impact) {
+	Graph g = analysis->g;
+	int *dist = analysis->ws->dist;
+	int *order = analysis->ws->order;
+	struct connection link = impact->connection;
+	int numLost = 0;
+
+	int ends[2] = {link.computerA, link.computerB};
+	for (int i = 0; i < 2; i++) {
+		if (dist[ends[i]] != INT_MAX) {
+			PqInsert(pq, ends[i], dist[ends[i]]);
+		}
+	}
+
+	while (PqSize(pq) > 0) {
+		int u = PqDelete(pq);
+		if (u == analysis->source || keepsTime(&analysis->ws->dag, dist, lost, link, u)) {
+			continue;
+		}
+
+		lost[u] = true;
+		lostList[numLost++] = u;
+
+		GraphArcSpan arcs = GraphGetOutArcs(g, u);
+		for (int i = 0; i < arcs.count; i++) {
+			int w = arcs.vertices[i];
+			if (!lost[w] && !onLink(link, u, w) && isRecipient(dist, u, w, arcs.costs[i]) && !PqContains(pq, w)) {
+				PqInsert(pq, w, dist[w]);
+			}
+		}
+	}
+
+	// every computer that kept its time did so without the connection, so the lost ones start from the best
+	// any of those can do for them
+	for (int i = 0; i < numLost; i++) {
+		int u = lostList[i];
+		GraphArcSpan arcs = GraphGetInArcs(g, u);
+		for (int k = 0; k < arcs.count; k++) {
+			int v = arcs.vertices[k];
+			if (!lost[v] && !onLink(link, v, u) && dist[v] < INT_MAX - arcs.costs[k] && dist[v] + arcs.costs[k] < time[u]) {
+				time[u] = dist[v] + arcs.costs[k];
+			}
+		}
+		if (time[u] != INT_MAX) {
+			PqInsert(pq, u, time[u]);
+		}
+	}
+
+	while (PqSize(pq) > 0) {
+		int v = PqDelete(pq);
+		GraphArcSpan arcs = GraphGetOutArcs(g, v);
+
+		for (int i = 0; i < arcs.count; i++) {
+			int u = arcs.vertices[i];
+			if (lost[u] && !onLink(link, v, u) && time[v] < INT_MAX - arcs.costs[i] && time[v] + arcs.costs[i] < time[u]) {
+				time[u] = time[v] + arcs.costs[i];
+				if (PqContains(pq, u)) {
+					PqUpdate(pq, u, time[u]);
+				} else {
+					PqInsert(pq, u, time[u]);
+				}
+			}
+		}
+	}
+
+	// the makespan is the latest of the lost computers' new times and the times that stood. the source always
+	// keeps its time, so some computer in the order has
+	int makespan = 0;
+	int numCutOff = 0;
+	for (int i = 0; i < numLost; i++) {
+		int u = lostList[i];
+		if (time[u] == INT_MAX) {
+			numCutOff++;
+		} else if (time[u] > makespan) {
+			makespan = time[u];
+		}
+	}
+	for (int i = analysis->numSettled - 1; i >= 0; i--) {
+		if (!lost[order[i]]) {
+			makespan = dist[order[i]] > makespan ? dist[order[i]] : makespan;
+			break;
+		}
+	}
+
+	impact->makespan = makespan;
+	impact->makespanDelta = makespan - dist[order[analysis->numSettled - 1]];
+	impact->reachedDelta = -numCutOff;
+
+	for (int i = 0; i < numLost; i++) {
+		lost[lostList[i]] = false;
+		time[lostList[i]] = INT_MAX;
+	}
+}
+
+// a helper function that checks whether u keeps its time once link is lost, i.e. whether a computer that
+// keeps its own was one of u's senders, strictly earlier and not over link
+static bool keepsTime(struct senders *dag, int dist[], bool lost[], struct connection link, int u) {
+	for (int e = dag->first[u]; e != -1; e = dag->next[e]) {
+		int v = dag->sender[e];
+		if (!lost[v] && dist[v] < dist[u] && !onLink(link, v, u)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// a helper function that checks whether the arc v -> w runs over link
+static bool onLink(struct connection link, int v, int w) {
+	return (v == link.computerA && w == link.computerB) || (v == link.computerB && w == link.computerA);
+}
+
+// a helper function that compares link impacts for qsort, by their connections' computers
+static int compareLinks(const void *a, const void *b) {
+	struct connection *linkA = &((struct linkImpact *)a)->connection;
+	struct connection *linkB = &((struct linkImpact *)b)->connection;
+
+	if (linkA->computerA != linkB->computerA) {
+		return compareComputers(&linkA->computerA, &linkB->computerA);
+	}
+	return compareComputers(&linkA->computerB, &linkB->computerB);
+}
+
+// a helper function that compares link impacts for qsort, the most damaging first: the most computers cut
+// off, then the latest makespan, then by connection
+static int compareImpacts(const void *a, const void *b) {
+	struct linkImpact *impactA = (struct linkImpact *)a;
+	struct linkImpact *impactB = (struct linkImpact *)b;
+
+	if (impactA->reachedDelta != impactB->reachedDelta) {
+		return (impactA->reachedDelta > impactB->reachedDelta) - (impactA->reachedDelta < impactB->reachedDelta);
+	}
+	if (impactA->makespanDelta != impactB->makespanDelta) {
+		return (impactA->makespanDelta < impactB->makespanDelta) - (impactA->makespanDelta > impactB->makespanDelta);
+	}
+	return compareLinks(a, b);
+}
+
+// a helper function that lays the first numSteps steps of a finished search out in one block. a computer's
+// recipients are the computers in the plan it is a sender of; visiting those in ascending order while
+// appending each to its senders' lists leaves every recipient list sorted without any per-list sorting
+static struct poodlePlan createPlan(Graph g, struct searchWorkspace *ws, int numSettled, int numSteps) {
+	int numComputers = GraphNumVertices(g);
+	struct poodlePlan plan = {numSteps, NULL, NULL, NULL, NULL};
+	struct senders *dag = &ws->dag;
+
+	for (int i = 0; i < numSettled; i++) {
+		ws->position[ws->order[i]] = i;
+	}
+
+	int numRecipients = 0;
+	for (int i = 0; i < numSteps; i++) {
+		for (int e = dag->first[ws->order[i]]; e != -1; e = dag->next[e]) {
+			if (inPlan(ws, dag->sender[e], numSteps)) {
+				numRecipients++;
+			}
+		}
+	}
+
+	int *block = malloc((3 * (size_t)numSteps + 1 + numRecipients) * sizeof(int));
+	int *next = malloc(numSteps * sizeof(int));			// where the next recipient of each step goes
+	if (block == NULL || (numSteps > 0 && next == NULL)) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	plan.computers = block;
+	plan.times = plan.computers + numSteps;
+	plan.offsets = plan.times + numSteps;
+	plan.recipients = plan.offsets + numSteps + 1;
+
+	memset(plan.offsets, 0, (numSteps + 1) * sizeof(int));
+	for (int i = 0; i < numSteps; i++) {
+		plan.computers[i] = ws->order[i];
+		plan.times[i] = ws->dist[ws->order[i]];
+		for (int e = dag->first[ws->order[i]]; e != -1; e = dag->next[e]) {
+			if (inPlan(ws, dag->sender[e], numSteps)) {
+				plan.offsets[ws->position[dag->sender[e]] + 1]++;
+			}
+		}
+	}
+	for (int i = 0; i < numSteps; i++) {
+		plan.offsets[i + 1] += plan.offsets[i];
+		next[i] = plan.offsets[i];
+	}
+
+	// a small plan is visited through a sorted copy of its computers rather than a scan of the whole network
+	bool small = numSteps < numComputers / 16;
+	int *ascending = NULL;
+	if (small) {
+		ascending = malloc(numSteps * sizeof(int));
+		if (numSteps > 0 && ascending == NULL) {
+			fprintf(stderr, "Error: out of memory");
+			exit(1);
+		}
+		memcpy(ascending, ws->order, numSteps * sizeof(int));
+		qsort(ascending, numSteps, sizeof(int), compareComputers);
+	}
+
+	for (int k = 0; k < (small ? numSteps : numComputers); k++) {
+		int u = small ? ascending[k] : k;
+		if (!inPlan(ws, u, numSteps)) {
+			continue;
+		}
+
+		for (int e = dag->first[u]; e != -1; e = dag->next[e]) {
+			if (inPlan(ws, dag->sender[e], numSteps)) {
+				plan.recipients[next[ws->position[dag->sender[e]]]++] = u;
+			}
+		}
+	}
+
+	free(ascending);
+	free(next);
+
+	return plan;
+}
+
+// a helper function that checks whether a computer is in the first numSteps steps of a finished search
+static bool inPlan(struct searchWorkspace *ws, int computer, int numSteps) {
+	return ws->sptSet[computer] && ws->position[computer] < numSteps;
+}
+
+// a helper function that sorts computers by time, breaking ties by computer number
+static void orderByTime(int order[], int numSteps, int dist[]) {
+	struct step *steps = malloc(numSteps * sizeof(struct step));
+	if (numSteps > 0 && steps == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	for (int i = 0; i < numSteps; i++) {
+		steps[i].computer = order[i];
+		steps[i].time = dist[order[i]];
+		steps[i].recipients = NULL;
+	}
+
+	qsort(steps, numSteps, sizeof(struct step), compareSteps);
+
+	for (int i = 0; i < numSteps; i++) {
+		order[i] = steps[i].computer;
+	}
+
+	free(steps);
+}
+
+// a helper function that compares the steps for qsort
+static int compareSteps(const void *a, const void *b) {
+	struct step *stepA = (struct step *)a;
+	struct step *stepB = (struct step *)b;
+
+	if (stepA->time != stepB->time) {
+		return stepA->time < stepB->time ? -1 : 1;
+	}
+	return compareComputers(&stepA->computer, &stepB->computer);
+}
+
+// a helper function that compares computer numbers for qsort
+static int compareComputers(const void *a, const void *b) {
+	int computerA = *(int *)a;
+	int computerB = *(int *)b;
+
+	return (computerA > computerB) - (computerA < computerB);
+}
+
+// a helper function that converts a flat plan into a poodleResult. if packed, the steps and all of the
+// recipient nodes share one allocation. otherwise every node is allocated on its own, since that is how
+// the callers of poodle() free them
+static struct poodleResult planToResult(struct poodlePlan plan, bool packed) {
+	struct poodleResult res = {plan.numSteps, NULL};
+	int numRecipients = plan.offsets[plan.numSteps];
+
+	size_t size = plan.numSteps * sizeof(struct step);
+	if (packed) {
+		size += numRecipients * sizeof(struct computerList);
+	}
+
+	res.steps = malloc(size);
+	if (size > 0 && res.steps == NULL) {
+		fprintf(stderr, "Error: out of memory");
+		exit(1);
+	}
+
+	struct computerList *nodes = (struct computerList *)&res.steps[plan.numSteps];
+	for (int i = 0; i < plan.numSteps; i++) {
+		res.steps[i].computer = plan.computers[i];
+		res.steps[i].time = plan.times[i];
+		res.steps[i].recipients = NULL;
+
+		// link the nodes back to front so each one can point at the one after it
+		for (int k = plan.offsets[i + 1] - 1; k >= plan.offsets[i]; k--) {
+			struct computerList *node = packed ? &nodes[k] : malloc(sizeof(struct computerList));
+			if (node == NULL) {
+				fprintf(stderr, "Error: out of memory");
+				exit(1);
+			}
+
+			node->computer = plan.recipients[k];
+			node->next = res.steps[i].recipients;
+			res.steps[i].recipients = node;
+		}
+	}
+
+	return res;
+}
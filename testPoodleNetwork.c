@@ -0,0 +1,1473 @@
+// Unit tests for the PoodleNetwork functions that have no task of their
+// own, and for the ADTs under them. Each test checks answers against PoodleNetworkPoodle (which the task 3
+// tests cover) or against times worked out by hand, and prints the checks
+// that fail. Build with make testPoodleNetwork, and run ./testPoodleNetwork
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "BucketQueue.h"
+#include "Graph.h"
+#include "PoodleNetwork.h"
+#include "PriorityQueue.h"
+
+// The number of computers and connections in the larger generated networks
+#define NUM_GENERATED 300
+#define NUM_GENERATED_CONNECTIONS (3 * NUM_GENERATED)
+
+// The network in data/network-3a.txt, whose plan from computer 2 is in
+// task3/1.exp
+static struct computer sampleComputers[] = {
+	{2, 1}, {4, 1}, {1, 1}, {2, 1}, {3, 1}, {2, 1}, {3, 1},
+};
+static struct connection sampleConnections[] = {
+	{0, 1, 4}, {0, 2, 7}, {0, 3, 1}, {0, 4, 1}, {1, 4, 6}, {2, 3, 3},
+	{3, 4, 5}, {2, 5, 6}, {2, 6, 4}, {3, 6, 6}, {4, 6, 2}, {5, 6, 2},
+};
+
+// When each computer in the sample network is poodled from computer 2
+static int sampleTimes[] = {7, 16, 1, 5, 9, 8, 11};
+
+// The network in data/network-3f.txt: computer 0 can never be poodled, so
+// nothing is poodled from it, and computer 1 is poodled at 3 seconds and
+// cannot send the pug to 0 in time
+static struct computer unreachableComputers[] = {{1, INFINITY}, {1, 3}};
+static struct connection unreachableConnections[] = {{0, 1, 2}};
+
+#define CHECK(cond) check((cond), #cond, __func__, __LINE__)
+
+static int numFailed = 0;
+static int numChecked = 0;
+
+static void testGraphEdges(void);
+static void testGraphDuplicates(void);
+static void testGraphArcs(void);
+static void testPriorityQueue(void);
+static void testBucketQueue(void);
+static void testEngines(void);
+static void testReachableRepeated(void);
+static void testReachableDense(void);
+static void testLateTimes(void);
+static void testLayouts(void);
+static void testStream(void);
+static void testBounded(void);
+static void testPoodleTime(void);
+static void testHierarchy(void);
+static void testMultiSource(void);
+static void testBatch(void);
+static void testFastestSource(void);
+static void testChanges(void);
+static void testChooseSource(void);
+static void testChooseSourceChanges(void);
+static void testCriticalLinks(void);
+
+static void check(bool ok, char *cond, const char *func, int line);
+static void checkNeighbours(Graph g, int v, int numNeighbours, int neighbours[], int times[]);
+static PoodleNetwork newSample(void);
+static PoodleNetwork newUnreachable(void);
+static PoodleNetwork newEmpty(void);
+static PoodleNetwork newGenerated(unsigned int seed, int maxTime);
+static void generateNetwork(
+	unsigned int seed, int maxTime,
+	struct computer computers[], struct connection connections[]
+);
+static int plainReachable(
+	struct computer computers[], int numComputers,
+	struct connection connections[], int numConnections,
+	int src, int reachable[]
+);
+static bool samePlan(struct poodleResult a, struct poodleResult b);
+static bool sameStep(struct step a, struct step b);
+static void freeResult(struct poodleResult res);
+static int *planTimes(PoodleNetwork net, int src);
+static void randomChanges(
+	struct networkChange changes[], int numChanges, int maxTime,
+	struct connection added[], int *numAdded
+);
+
+int main(void) {
+	testGraphEdges();
+	testGraphDuplicates();
+	testGraphArcs();
+	testPriorityQueue();
+	testBucketQueue();
+	testEngines();
+	testLateTimes();
+	testLayouts();
+	testStream();
+	testBounded();
+	testPoodleTime();
+	testHierarchy();
+	testMultiSource();
+	testBatch();
+	testFastestSource();
+	testChanges();
+	testReachableRepeated();
+	testReachableDense();
+	testChooseSource();
+	testChooseSourceChanges();
+	testCriticalLinks();
+
+	if (numFailed > 0) {
+		printf("%d of %d checks failed\n", numFailed, numChecked);
+		return EXIT_FAILURE;
+	}
+	printf("All %d checks passed\n", numChecked);
+	return EXIT_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Tests
+
+// A vertex's neighbours are kept in the order its edges were made, and
+// inserting or removing an edge only changes the rows of its two ends
+static void testGraphEdges(void) {
+	struct computer computers[] = {{1, 0}, {1, 0}, {1, 0}, {1, 0}, {1, 0}};
+	struct connection connections[] = {{0, 1, 3}, {2, 0, 4}, {0, 3, 5}, {3, 1, 6}};
+	Graph g = GraphBuild(5, computers, connections, 4);
+	CHECK(GraphNumEdges(g) == 4);
+	checkNeighbours(g, 0, 3, (int[]){1, 2, 3}, (int[]){3, 4, 5});
+	checkNeighbours(g, 1, 2, (int[]){0, 3}, (int[]){3, 6});
+	checkNeighbours(g, 2, 1, (int[]){0}, (int[]){4});
+	checkNeighbours(g, 3, 2, (int[]){0, 1}, (int[]){5, 6});
+	checkNeighbours(g, 4, 0, NULL, NULL);
+
+	// inserting appends to both rows, unless the edge is already there
+	GraphInsertEdge(g, 4, 0, 7);
+	GraphInsertEdge(g, 1, 0, 9);
+	CHECK(GraphNumEdges(g) == 5);
+	checkNeighbours(g, 0, 4, (int[]){1, 2, 3, 4}, (int[]){3, 4, 5, 7});
+	checkNeighbours(g, 1, 2, (int[]){0, 3}, (int[]){3, 6});
+	checkNeighbours(g, 4, 1, (int[]){0}, (int[]){7});
+
+	// removing closes the gap, keeping the order of what is left
+	GraphRemoveEdge(g, 2, 0);
+	GraphRemoveEdge(g, 2, 4);
+	CHECK(GraphNumEdges(g) == 4);
+	CHECK(!GraphIsAdjacent(g, 0, 2) && !GraphIsAdjacent(g, 2, 0));
+	CHECK(GraphGetTransmissionTime(g, 0, 2) == -1);
+	checkNeighbours(g, 0, 3, (int[]){1, 3, 4}, (int[]){3, 5, 7});
+	checkNeighbours(g, 1, 2, (int[]){0, 3}, (int[]){3, 6});
+	checkNeighbours(g, 2, 0, NULL, NULL);
+	checkNeighbours(g, 3, 2, (int[]){0, 1}, (int[]){5, 6});
+
+	// a batch of changes leaves the edges just as the same changes one at a time
+	GraphBeginChanges(g);
+	GraphRemoveEdge(g, 0, 1);
+	GraphInsertEdge(g, 2, 3, 8);
+	GraphInsertEdge(g, 0, 1, 2);
+	GraphEndChanges(g);
+	CHECK(GraphNumEdges(g) == 5);
+	checkNeighbours(g, 0, 3, (int[]){3, 4, 1}, (int[]){5, 7, 2});
+	checkNeighbours(g, 1, 2, (int[]){3, 0}, (int[]){6, 2});
+	checkNeighbours(g, 2, 1, (int[]){3}, (int[]){8});
+	checkNeighbours(g, 3, 3, (int[]){0, 1, 2}, (int[]){5, 6, 8});
+	checkNeighbours(g, 4, 1, (int[]){0}, (int[]){7});
+	GraphFree(g);
+
+	g = GraphBuild(0, NULL, NULL, 0);
+	CHECK(GraphNumVertices(g) == 0 && GraphNumEdges(g) == 0);
+	GraphFree(g);
+}
+
+// When the same pair of computers is connected more than once, in either
+// orientation, the first connection is the one that is kept
+static void testGraphDuplicates(void) {
+	struct computer computers[] = {{1, 0}, {1, 0}, {1, 0}};
+	struct connection connections[] = {
+		{2, 0, 5}, {0, 2, 9}, {0, 1, 1}, {1, 0, 4}, {2, 0, 7}, {1, 2, 3}, {2, 1, 8},
+	};
+	Graph g = GraphBuild(3, computers, connections, 7);
+	CHECK(GraphNumEdges(g) == 3);
+	checkNeighbours(g, 0, 2, (int[]){2, 1}, (int[]){5, 1});
+	checkNeighbours(g, 1, 2, (int[]){0, 2}, (int[]){1, 3});
+	checkNeighbours(g, 2, 2, (int[]){0, 1}, (int[]){5, 3});
+	GraphFree(g);
+
+	// with no connections at all, the sort still has room to work in
+	g = GraphBuild(3, computers, NULL, 0);
+	CHECK(GraphNumEdges(g) == 0);
+	checkNeighbours(g, 0, 0, NULL, NULL);
+	GraphFree(g);
+}
+
+// Checks a graph's compiled arcs against the rule they are compiled by,
+// and against a graph built afresh with the same edges. The rows into a
+// vertex are in ascending order of sender however the graph came about;
+// the rows out of one follow its edges, so only their contents are
+// compared
+static void checkArcs(Graph g, Graph fresh) {
+	int numVert = GraphNumVertices(g);
+	CHECK(GraphNumArcs(g) == GraphNumArcs(fresh));
+	CHECK(GraphMaxArcCost(g) == GraphMaxArcCost(fresh));
+
+	int numArcs = 0;
+	int maxCost = 0;
+	for (int v = 0; v < numVert; v++) {
+		GraphArcSpan out = GraphGetOutArcs(g, v);
+		GraphArcSpan freshOut = GraphGetOutArcs(fresh, v);
+		CHECK(out.count == freshOut.count);
+		for (int i = 0; i < out.count; i++) {
+			int w = out.vertices[i];
+			long long cost = (long long)GraphGetTransmissionTime(g, v, w) + GraphGetPoodleTime(g, w);
+			CHECK(GraphGetSecurityLevel(g, w) <= GraphGetSecurityLevel(g, v) + 1);
+			CHECK(out.costs[i] == (cost > INFINITY ? INFINITY : cost));
+			bool inFresh = false;
+			for (int k = 0; k < freshOut.count; k++) {
+				inFresh = inFresh || (freshOut.vertices[k] == w && freshOut.costs[k] == out.costs[i]);
+			}
+			CHECK(inFresh);
+			maxCost = out.costs[i] > maxCost ? out.costs[i] : maxCost;
+		}
+		numArcs += out.count;
+
+		GraphArcSpan in = GraphGetInArcs(g, v);
+		GraphArcSpan freshIn = GraphGetInArcs(fresh, v);
+		CHECK(in.count == freshIn.count);
+		for (int i = 0; i < in.count && i < freshIn.count; i++) {
+			CHECK(in.vertices[i] == freshIn.vertices[i]);
+			CHECK(in.costs[i] == freshIn.costs[i]);
+			CHECK(i == 0 || in.vertices[i - 1] < in.vertices[i]);
+		}
+	}
+	CHECK(GraphNumArcs(g) == numArcs);
+	CHECK(GraphMaxArcCost(g) == maxCost);
+}
+
+// The arcs of a changed graph are those of the same graph built afresh,
+// laid out the same way, with costs capped at INFINITY
+static void testGraphArcs(void) {
+	struct computer computers[] = {
+		{3, 2}, {2, INFINITY - 1}, {4, 1}, {3, INFINITY}, {1, 5}, {2, 7},
+	};
+	struct connection connections[] = {
+		{4, 5, 2}, {0, 1, 1}, {0, 2, 4}, {5, 3, 1}, {2, 1, 3}, {1, 3, 6}, {3, 0, 2},
+	};
+	Graph g = GraphBuild(6, computers, connections, 7);
+	Graph fresh = GraphBuild(6, computers, connections, 7);
+	checkArcs(g, fresh);
+	CHECK(GraphMaxArcCost(g) == INFINITY);
+	GraphFree(fresh);
+
+	// one change at a time: 5 connects to 0, after 0 already connects to 1
+	// and 3, so the patched row into 0 has to be put back in order
+	GraphInsertEdge(g, 5, 0, 1);
+	GraphInsertEdge(g, 2, 5, 2);
+	GraphRemoveEdge(g, 0, 2);
+	struct connection changed[] = {
+		{4, 5, 2}, {0, 1, 1}, {5, 3, 1}, {2, 1, 3}, {1, 3, 6}, {3, 0, 2}, {5, 0, 1},
+		{2, 5, 2},
+	};
+	fresh = GraphBuild(6, computers, changed, 8);
+	checkArcs(g, fresh);
+	GraphFree(fresh);
+
+	// a batch of changes, with new security levels and poodle times
+	GraphBeginChanges(g);
+	GraphInsertEdge(g, 4, 0, 9);
+	GraphSetVertexInfo(g, 0, 1, INFINITY);
+	GraphSetVertexInfo(g, 3, 2, 4);
+	GraphRemoveEdge(g, 1, 3);
+	GraphInsertEdge(g, 4, 3, 1);
+	GraphEndChanges(g);
+	computers[0] = (struct computer){1, INFINITY};
+	computers[3] = (struct computer){2, 4};
+	struct connection batched[] = {
+		{4, 5, 2}, {0, 1, 1}, {5, 3, 1}, {2, 1, 3}, {3, 0, 2}, {5, 0, 1}, {2, 5, 2},
+		{4, 0, 9}, {4, 3, 1},
+	};
+	fresh = GraphBuild(6, computers, batched, 9);
+	checkArcs(g, fresh);
+	GraphFree(fresh);
+	GraphFree(g);
+}
+
+// The heap gives items back by priority through decrease-key, raised keys
+// and growth, which is checked against a scan of what is left. It starts
+// small, and the items go past its capacity, so both of its arrays grow
+static void testPriorityQueue(void) {
+	int numItems = 200;
+	int priorities[200];
+	bool queued[200] = {false};
+	Pq pq = PqNew();
+
+	srand(22);
+	for (int i = 0; i < numItems; i++) {
+		int item = (i * 7) % numItems;
+		priorities[item] = rand() % 1000;
+		PqInsert(pq, item, priorities[item]);
+		queued[item] = true;
+	}
+	CHECK(PqSize(pq) == numItems);
+
+	for (int item = 0; item < numItems; item += 3) {
+		priorities[item] = (item % 2 == 0 ? priorities[item] / 2 : priorities[item] + 500);
+		PqUpdate(pq, item, priorities[item]);
+	}
+
+	for (int n = numItems; n > 0; n--) {
+		int min = -1;
+		for (int item = 0; item < numItems; item++) {
+			if (queued[item] && (min == -1 || priorities[item] < priorities[min])) {
+				min = item;
+			}
+		}
+
+		CHECK(PqPeekPriority(pq) == priorities[min]);
+		int item = PqPeek(pq);
+		CHECK(PqDelete(pq) == item);
+		CHECK(queued[item] && priorities[item] == priorities[min]);
+		CHECK(PqContains(pq, item) == false);
+		queued[item] = false;
+		CHECK(PqSize(pq) == n - 1);
+	}
+	CHECK(!PqContains(pq, numItems + 100));
+
+	// a deleted item can be inserted again
+	PqInsert(pq, 5, 7);
+	PqInsert(pq, 3, 9);
+	PqUpdate(pq, 3, 1);
+	CHECK(PqContains(pq, 3) && PqContains(pq, 5));
+	CHECK(PqDelete(pq) == 3 && PqDelete(pq) == 5);
+	PqFree(pq);
+}
+
+// A bucket queue used as Dijkstra's algorithm uses it: every priority is
+// within maxStep of the last one deleted, and the priorities run far past
+// the number of buckets, so the buckets are reused round and round. Items
+// come out by priority, and in the order they were put in their bucket on
+// ties, which is checked against a scan of what is left
+static void testBucketQueue(void) {
+	int numItems = 50;
+	int maxStep = 5;
+	int priorities[50];
+	int linked[50];			// when each item was last put in its bucket
+	bool queued[50] = {false};
+	BucketQueue bq = BucketQueueNew(numItems, maxStep);
+
+	// the first priority inserted is where the queue starts from
+	srand(23);
+	int last = 1000;
+	int numLinked = 0;
+	for (int round = 0; round < 2000; round++) {
+		int item = rand() % numItems;
+		int priority = round == 0 ? last : last + rand() % (maxStep + 1);
+		if (!queued[item]) {
+			BucketQueueInsert(bq, item, priority);
+			queued[item] = true;
+		} else if (priority < priorities[item]) {
+			BucketQueueUpdate(bq, item, priority);
+		} else {
+			priority = -1;
+		}
+		if (priority != -1) {
+			priorities[item] = priority;
+			linked[item] = numLinked++;
+		}
+
+		if (round % 2 == 1 && BucketQueueSize(bq) > 0) {
+			int min = -1;
+			for (int v = 0; v < numItems; v++) {
+				if (queued[v] && (min == -1 || priorities[v] < priorities[min]
+						|| (priorities[v] == priorities[min] && linked[v] < linked[min]))) {
+					min = v;
+				}
+			}
+
+			CHECK(BucketQueueDelete(bq) == min);
+			CHECK(!BucketQueueContains(bq, min));
+			queued[min] = false;
+			last = priorities[min];
+		}
+	}
+	CHECK(last > 1000 + 10 * (maxStep + 1));		// at least ten times round the buckets
+
+	// once cleared, the queue starts again from any priority
+	BucketQueueClear(bq);
+	CHECK(BucketQueueSize(bq) == 0);
+	BucketQueueInsert(bq, 8, 2);
+	BucketQueueInsert(bq, 7, 3);
+	CHECK(BucketQueueDelete(bq) == 8 && BucketQueueDelete(bq) == 7);
+	BucketQueueFree(bq);
+}
+
+// Every engine gives the heap's plan, on any number of threads
+static void testEngines(void) {
+	Engine engines[] = {ENGINE_AUTO, ENGINE_BUCKET, ENGINE_PARALLEL};
+	int maxTimes[] = {3, 1000, INFINITY / 4};
+
+	for (int i = 0; i < 3; i++) {
+		PoodleNetwork net = newGenerated(i + 1, maxTimes[i]);
+		for (int src = 0; src < NUM_GENERATED; src += 37) {
+			PoodleNetworkSetEngine(net, ENGINE_HEAP);
+			struct poodleResult want = PoodleNetworkPoodle(net, src);
+			for (int e = 0; e < 3; e++) {
+				for (int threads = 1; threads <= 4; threads += 3) {
+					PoodleNetworkSetEngine(net, engines[e]);
+					PoodleNetworkSetThreads(net, threads);
+					struct poodleResult res = PoodleNetworkPoodle(net, src);
+					CHECK(samePlan(res, want));
+					freeResult(res);
+				}
+			}
+			freeResult(want);
+		}
+		PoodleNetworkFree(net);
+	}
+
+	PoodleNetwork net = newSample();
+	for (int e = 0; e < 3; e++) {
+		PoodleNetworkSetEngine(net, engines[e]);
+		struct poodleResult res = PoodleNetworkPoodle(net, 2);
+		CHECK(res.numSteps == 7);
+		for (int i = 0; i < res.numSteps; i++) {
+			CHECK(res.steps[i].time == sampleTimes[res.steps[i].computer]);
+		}
+		freeResult(res);
+	}
+	PoodleNetworkFree(net);
+
+	// a source that is never poodled starts nothing, whatever the engine
+	net = newUnreachable();
+	for (int e = 0; e < 3; e++) {
+		PoodleNetworkSetEngine(net, engines[e]);
+		struct poodleResult res = PoodleNetworkPoodle(net, 0);
+		CHECK(res.numSteps == 0);
+		freeResult(res);
+	}
+	PoodleNetworkFree(net);
+}
+
+// Every engine copes with times just short of INFINITY. Computers 0 to 2
+// are poodled late, but nothing can send the pug to them, so the network's
+// steps are all cheap next to how many there are. Delta-stepping's
+// buckets are then one second wide, and from those sources the last
+// bucket numbers are right at the edge of an int
+static void testLateTimes(void) {
+	int numComputers = 40;
+	struct computer computers[40];
+	struct connection connections[40 * 39 / 2];
+	int numConnections = 0;
+	for (int a = 0; a < numComputers; a++) {
+		computers[a] = (struct computer){a < 3 ? 3 : 1, 1};
+		for (int b = (a < 3 ? 3 : a + 1); b < numComputers; b++) {
+			connections[numConnections++] = (struct connection){a, b, 1};
+		}
+	}
+	computers[0].poodleTime = INFINITY - 3;
+	computers[1].poodleTime = INFINITY - 1;
+	computers[2].poodleTime = INFINITY;
+	int numSteps[] = {numComputers - 2, 1, 0, numComputers - 3};
+
+	PoodleNetwork net = PoodleNetworkNew(computers, numComputers, connections, numConnections);
+	Engine engines[] = {ENGINE_AUTO, ENGINE_BUCKET, ENGINE_PARALLEL};
+	for (int src = 0; src < 4; src++) {
+		PoodleNetworkSetEngine(net, ENGINE_HEAP);
+		struct poodleResult want = PoodleNetworkPoodle(net, src);
+		for (int e = 0; e < 3; e++) {
+			PoodleNetworkSetEngine(net, engines[e]);
+			struct poodleResult res = PoodleNetworkPoodle(net, src);
+			CHECK(samePlan(res, want));
+			freeResult(res);
+		}
+		CHECK(want.numSteps == numSteps[src]);
+		freeResult(want);
+	}
+	PoodleNetworkFree(net);
+}
+
+// The packed and flat plans hold the same steps as the plain plan
+static void testLayouts(void) {
+	PoodleNetwork nets[] = {newSample(), newGenerated(4, 50), newUnreachable()};
+	int sources[] = {2, 9, 0};
+
+	for (int i = 0; i < 3; i++) {
+		struct poodleResult want = PoodleNetworkPoodle(nets[i], sources[i]);
+
+		struct poodleResult packed = PoodleNetworkPoodlePacked(nets[i], sources[i]);
+		CHECK(samePlan(packed, want));
+		free(packed.steps);
+
+		struct poodlePlan plan = PoodleNetworkPoodlePlan(nets[i], sources[i]);
+		CHECK(plan.numSteps == want.numSteps);
+		for (int j = 0; j < plan.numSteps && j < want.numSteps; j++) {
+			CHECK(plan.computers[j] == want.steps[j].computer);
+			CHECK(plan.times[j] == want.steps[j].time);
+			int k = plan.offsets[j];
+			struct computerList *curr = want.steps[j].recipients;
+			for (; k < plan.offsets[j + 1] && curr != NULL; k++, curr = curr->next) {
+				CHECK(plan.recipients[k] == curr->computer);
+			}
+			CHECK(k == plan.offsets[j + 1] && curr == NULL);
+		}
+		PoodlePlanFree(plan);
+
+		freeResult(want);
+		PoodleNetworkFree(nets[i]);
+	}
+}
+
+// What testStream's callback compares the streamed steps with
+struct streamCheck {
+	struct poodleResult want;
+	int numStreamed;
+	bool same;
+};
+
+static void checkStreamedStep(struct step step, void *context) {
+	struct streamCheck *sc = context;
+	if (sc->numStreamed >= sc->want.numSteps
+			|| !sameStep(step, sc->want.steps[sc->numStreamed])) {
+		sc->same = false;
+	}
+	sc->numStreamed++;
+}
+
+// A stream hands over the plan's steps in order, on any engine
+static void testStream(void) {
+	PoodleNetwork nets[] = {newSample(), newGenerated(5, 50), newUnreachable()};
+	int sources[] = {2, 11, 0};
+	Engine engines[] = {ENGINE_HEAP, ENGINE_BUCKET, ENGINE_PARALLEL};
+
+	for (int i = 0; i < 3; i++) {
+		struct streamCheck sc = {PoodleNetworkPoodle(nets[i], sources[i]), 0, true};
+		for (int e = 0; e < 3; e++) {
+			PoodleNetworkSetEngine(nets[i], engines[e]);
+			sc.numStreamed = 0;
+			sc.same = true;
+			PoodleNetworkPoodleStream(nets[i], sources[i], checkStreamedStep, &sc);
+			CHECK(sc.same && sc.numStreamed == sc.want.numSteps);
+		}
+		freeResult(sc.want);
+		PoodleNetworkFree(nets[i]);
+	}
+}
+
+// Checks a bounded plan against the start of the full plan, with the
+// recipients outside of it left out
+static void checkBounded(PoodleNetwork net, int src, int deadline, int maxSteps) {
+	struct poodleResult full = PoodleNetworkPoodle(net, src);
+	int numKept = 0;
+	while (numKept < full.numSteps && numKept < maxSteps
+			&& full.steps[numKept].time <= deadline) {
+		numKept++;
+	}
+
+	bool *kept = calloc(PoodleNetworkNumComputers(net), sizeof(bool));
+	if (kept == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < numKept; i++) {
+		kept[full.steps[i].computer] = true;
+	}
+
+	struct poodleResult res = PoodleNetworkPoodleBounded(net, src, deadline, maxSteps);
+	CHECK(res.numSteps == numKept);
+	for (int i = 0; i < res.numSteps && i < numKept; i++) {
+		CHECK(res.steps[i].computer == full.steps[i].computer);
+		CHECK(res.steps[i].time == full.steps[i].time);
+		struct computerList *curr = res.steps[i].recipients;
+		struct computerList *want = full.steps[i].recipients;
+		for (; want != NULL; want = want->next) {
+			if (kept[want->computer]) {
+				CHECK(curr != NULL && curr->computer == want->computer);
+				curr = (curr != NULL ? curr->next : NULL);
+			}
+		}
+		CHECK(curr == NULL);
+	}
+
+	free(kept);
+	freeResult(res);
+	freeResult(full);
+}
+
+// A bounded plan stops at the deadline or after maxSteps steps, whichever
+// comes first
+static void testBounded(void) {
+	PoodleNetwork net = newSample();
+	for (int deadline = 0; deadline <= 17; deadline++) {
+		checkBounded(net, 2, deadline, 7);
+	}
+	for (int maxSteps = 0; maxSteps <= 7; maxSteps++) {
+		checkBounded(net, 2, INFINITY, maxSteps);
+		checkBounded(net, 2, 9, maxSteps);
+	}
+	PoodleNetworkFree(net);
+
+	net = newGenerated(6, 100);
+	for (int deadline = 50; deadline <= 800; deadline += 150) {
+		checkBounded(net, 17, deadline, NUM_GENERATED);
+		checkBounded(net, 17, deadline, 40);
+	}
+	checkBounded(net, 17, INFINITY, NUM_GENERATED);
+	PoodleNetworkFree(net);
+
+	net = newUnreachable();
+	checkBounded(net, 0, INFINITY, 2);
+	checkBounded(net, 1, INFINITY, 2);
+	checkBounded(net, 1, 2, 2);
+	PoodleNetworkFree(net);
+}
+
+// Checks PoodleNetworkPoodleTime from src against the full plan, for every
+// step-th computer
+static void checkPoodleTimes(PoodleNetwork net, int src, int step) {
+	int *times = planTimes(net, src);
+	for (int v = 0; v < PoodleNetworkNumComputers(net); v += step) {
+		CHECK(PoodleNetworkPoodleTime(net, src, v) == times[v]);
+	}
+	free(times);
+}
+
+// Point-to-point times agree with the full plan, including for computers
+// that are never poodled
+static void testPoodleTime(void) {
+	PoodleNetwork net = newSample();
+	for (int src = 0; src < 7; src++) {
+		checkPoodleTimes(net, src, 1);
+	}
+	PoodleNetworkFree(net);
+
+	net = newGenerated(7, 100);
+	for (int src = 0; src < NUM_GENERATED; src += 29) {
+		checkPoodleTimes(net, src, 7);
+	}
+	PoodleNetworkFree(net);
+
+	net = newUnreachable();
+	CHECK(PoodleNetworkPoodleTime(net, 0, 0) == INFINITY);
+	CHECK(PoodleNetworkPoodleTime(net, 0, 1) == INFINITY);
+	CHECK(PoodleNetworkPoodleTime(net, 1, 0) == INFINITY);
+	CHECK(PoodleNetworkPoodleTime(net, 1, 1) == 3);
+	PoodleNetworkFree(net);
+}
+
+// Once the contraction hierarchy is built, point-to-point times come from
+// it and still agree with the full plan. Preparing it again does nothing
+static void testHierarchy(void) {
+	PoodleNetwork net = newSample();
+	PoodleNetworkPrepareHierarchy(net);
+	PoodleNetworkPrepareHierarchy(net);
+	for (int src = 0; src < 7; src++) {
+		checkPoodleTimes(net, src, 1);
+	}
+	PoodleNetworkFree(net);
+
+	net = newGenerated(8, 100);
+	PoodleNetworkPrepareHierarchy(net);
+	for (int src = 0; src < NUM_GENERATED; src += 31) {
+		checkPoodleTimes(net, src, 5);
+	}
+	PoodleNetworkFree(net);
+
+	net = newUnreachable();
+	PoodleNetworkPrepareHierarchy(net);
+	checkPoodleTimes(net, 0, 1);
+	checkPoodleTimes(net, 1, 1);
+	PoodleNetworkFree(net);
+
+	net = newEmpty();
+	PoodleNetworkPrepareHierarchy(net);
+	PoodleNetworkFree(net);
+}
+
+// Checks that a multi-source plan poodles each computer at the earliest
+// time any one of the sources' plans does
+static void checkMultiSource(PoodleNetwork net, int sources[], int numSources) {
+	int numComputers = PoodleNetworkNumComputers(net);
+	int *want = planTimes(net, sources[0]);
+	for (int i = 1; i < numSources; i++) {
+		int *times = planTimes(net, sources[i]);
+		for (int v = 0; v < numComputers; v++) {
+			if (times[v] < want[v]) {
+				want[v] = times[v];
+			}
+		}
+		free(times);
+	}
+
+	int numReached = 0;
+	for (int v = 0; v < numComputers; v++) {
+		numReached += (want[v] != INFINITY);
+	}
+
+	struct poodleResult res = PoodleNetworkPoodleMultiSource(net, sources, numSources);
+	CHECK(res.numSteps == numReached);
+	for (int i = 0; i < res.numSteps; i++) {
+		CHECK(res.steps[i].time == want[res.steps[i].computer]);
+		CHECK(i == 0 || res.steps[i - 1].time <= res.steps[i].time);
+	}
+	freeResult(res);
+	free(want);
+}
+
+// A multi-source plan from one source is the plain plan, and from several
+// poodles each computer as soon as the pug reaches it from any of them
+static void testMultiSource(void) {
+	PoodleNetwork net = newSample();
+	int one[] = {2};
+	int repeated[] = {2, 2, 2};
+	struct poodleResult want = PoodleNetworkPoodle(net, 2);
+	struct poodleResult res = PoodleNetworkPoodleMultiSource(net, one, 1);
+	CHECK(samePlan(res, want));
+	freeResult(res);
+	res = PoodleNetworkPoodleMultiSource(net, repeated, 3);
+	CHECK(samePlan(res, want));
+	freeResult(res);
+	freeResult(want);
+
+	int several[] = {1, 5, 6};
+	checkMultiSource(net, several, 3);
+	res = PoodleNetworkPoodleMultiSource(net, NULL, 0);
+	CHECK(res.numSteps == 0);
+	freeResult(res);
+	PoodleNetworkFree(net);
+
+	net = newGenerated(9, 100);
+	int many[] = {3, 50, 77, 150, 299, 50};
+	for (int n = 2; n <= 6; n++) {
+		checkMultiSource(net, many, n);
+	}
+	PoodleNetworkFree(net);
+
+	net = newUnreachable();
+	int never[] = {0};
+	int both[] = {0, 1};
+	checkMultiSource(net, never, 1);
+	checkMultiSource(net, both, 2);
+	PoodleNetworkFree(net);
+
+	net = newEmpty();
+	res = PoodleNetworkPoodleMultiSource(net, NULL, 0);
+	CHECK(res.numSteps == 0);
+	freeResult(res);
+	PoodleNetworkFree(net);
+}
+
+// Checks a batch and its summaries against one plan at a time
+static void checkBatch(PoodleNetwork net, int sources[], int numSources) {
+	struct poodleResult results[NUM_GENERATED];
+	struct poodleSummary summaries[NUM_GENERATED];
+	PoodleNetworkPoodleBatch(net, sources, numSources, results);
+	PoodleNetworkPoodleSummaries(net, sources, numSources, summaries);
+
+	for (int i = 0; i < numSources; i++) {
+		struct poodleResult want = PoodleNetworkPoodle(net, sources[i]);
+		CHECK(samePlan(results[i], want));
+		CHECK(summaries[i].numSteps == want.numSteps);
+		CHECK(summaries[i].completionTime
+			== (want.numSteps > 0 ? want.steps[want.numSteps - 1].time : 0));
+		freeResult(want);
+		freeResult(results[i]);
+	}
+}
+
+// Batches give each source's plan, however the sources are shared out
+// between the threads
+static void testBatch(void) {
+	PoodleNetwork net = newGenerated(10, 100);
+	int sources[NUM_GENERATED];
+	for (int i = 0; i < NUM_GENERATED; i++) {
+		sources[i] = (i * 7) % NUM_GENERATED;
+	}
+	sources[1] = sources[0];
+	for (int threads = 1; threads <= 8; threads *= 2) {
+		PoodleNetworkSetThreads(net, threads);
+		checkBatch(net, sources, 1);
+		checkBatch(net, sources, 5);
+		checkBatch(net, sources, NUM_GENERATED);
+	}
+	PoodleNetworkFree(net);
+
+	net = newUnreachable();
+	int both[] = {0, 1};
+	checkBatch(net, both, 2);
+	struct poodleSummary summaries[2];
+	PoodleNetworkPoodleSummaries(net, both, 2, summaries);
+	CHECK(summaries[0].numSteps == 0 && summaries[0].completionTime == 0);
+	CHECK(summaries[1].numSteps == 1 && summaries[1].completionTime == 3);
+	PoodleNetworkFree(net);
+
+	net = newEmpty();
+	checkBatch(net, NULL, 0);
+	PoodleNetworkFree(net);
+}
+
+// Checks the fastest source against a full plan from every source that
+// reaches the most computers
+static void checkFastestSource(PoodleNetwork net) {
+	int numComputers = PoodleNetworkNumComputers(net);
+	struct fastestSourceResult want = {-1, 0, INFINITY};
+	for (int src = 0; src < numComputers; src++) {
+		int numReached = PoodleNetworkReachable(net, src, NULL);
+		struct poodleResult res = PoodleNetworkPoodle(net, src);
+		int makespan = (res.numSteps == numReached
+			? res.steps[res.numSteps - 1].time : INFINITY);
+		freeResult(res);
+
+		if (numReached > want.numComputers
+				|| (numReached == want.numComputers && makespan < want.makespan)) {
+			want = (struct fastestSourceResult){src, numReached, makespan};
+		}
+	}
+
+	struct fastestSourceResult res = PoodleNetworkFastestSource(net);
+	CHECK(res.sourceComputer == want.sourceComputer);
+	CHECK(res.numComputers == want.numComputers);
+	CHECK(res.makespan == want.makespan);
+}
+
+// The fastest source is the lowest numbered of those that reach the most
+// computers and finish first
+static void testFastestSource(void) {
+	PoodleNetwork net = newSample();
+	checkFastestSource(net);
+	PoodleNetworkFree(net);
+
+	for (unsigned int seed = 11; seed <= 14; seed++) {
+		net = newGenerated(seed, seed % 2 == 0 ? 3 : 100);
+		checkFastestSource(net);
+		PoodleNetworkFree(net);
+	}
+
+	net = newUnreachable();
+	checkFastestSource(net);
+	PoodleNetworkFree(net);
+
+	net = newEmpty();
+	struct fastestSourceResult res = PoodleNetworkFastestSource(net);
+	CHECK(res.sourceComputer == -1);
+	PoodleNetworkFree(net);
+}
+
+// Checks the tracked plan against a full search of the network as it is
+static void checkTracked(PoodleNetwork net, int src) {
+	struct poodleResult want = PoodleNetworkPoodle(net, src);
+	struct poodleResult res = PoodleNetworkTrackedPoodle(net);
+	CHECK(samePlan(res, want));
+	freeResult(res);
+	freeResult(want);
+
+	int *times = planTimes(net, src);
+	for (int v = 0; v < PoodleNetworkNumComputers(net); v++) {
+		CHECK(PoodleNetworkTrackedTime(net, v) == times[v]);
+	}
+	free(times);
+}
+
+// Changes give the same plans as building the changed network afresh, and
+// the tracked plan keeps up with them
+static void testChanges(void) {
+	PoodleNetwork net = newSample();
+	PoodleNetworkTrack(net, 2);
+	struct networkChange changes[] = {
+		{CHANGE_REMOVE_CONNECTION, {3, 2, 0}, 0, {0, 0}},
+		{CHANGE_ADD_CONNECTION, {2, 4, 1}, 0, {0, 0}},
+		{CHANGE_ADD_CONNECTION, {0, 1, 1}, 0, {0, 0}},		// already connected
+		{CHANGE_SET_COMPUTER, {0, 0, 0}, 5, {2, 20}},
+	};
+	PoodleNetworkApplyChanges(net, changes, 4);
+	checkTracked(net, 2);
+
+	struct computer computers[] = {
+		{2, 1}, {4, 1}, {1, 1}, {2, 1}, {3, 1}, {2, 20}, {3, 1},
+	};
+	struct connection connections[] = {
+		{0, 1, 4}, {0, 2, 7}, {0, 3, 1}, {0, 4, 1}, {1, 4, 6}, {2, 4, 1},
+		{3, 4, 5}, {2, 5, 6}, {2, 6, 4}, {3, 6, 6}, {4, 6, 2}, {5, 6, 2},
+	};
+	PoodleNetwork fresh = PoodleNetworkNew(computers, 7, connections, 12);
+	for (int src = 0; src < 7; src++) {
+		struct poodleResult res = PoodleNetworkPoodle(net, src);
+		struct poodleResult want = PoodleNetworkPoodle(fresh, src);
+		CHECK(samePlan(res, want));
+		freeResult(res);
+		freeResult(want);
+	}
+	PoodleNetworkFree(fresh);
+	PoodleNetworkFree(net);
+
+	net = newGenerated(15, 50);
+	PoodleNetworkTrack(net, 40);
+	struct connection added[30 * 8];
+	int numAdded = 0;
+	for (int round = 0; round < 30; round++) {
+		struct networkChange batch[8];
+		int numChanges = 1 + round % 8;
+		randomChanges(batch, numChanges, 50, added, &numAdded);
+		PoodleNetworkApplyChanges(net, batch, numChanges);
+		checkTracked(net, 40);
+	}
+	PoodleNetworkTrack(net, 41);
+	checkTracked(net, 41);
+	PoodleNetworkTrack(net, -1);
+	PoodleNetworkFree(net);
+
+	// the tracked source can stop and start being poodled
+	net = newUnreachable();
+	PoodleNetworkTrack(net, 0);
+	checkTracked(net, 0);
+	struct networkChange poodled = {CHANGE_SET_COMPUTER, {0, 0, 0}, 0, {1, 1}};
+	PoodleNetworkApplyChanges(net, &poodled, 1);
+	checkTracked(net, 0);
+	CHECK(PoodleNetworkTrackedTime(net, 1) == 6);
+	poodled.info.poodleTime = INFINITY;
+	PoodleNetworkApplyChanges(net, &poodled, 1);
+	checkTracked(net, 0);
+	PoodleNetworkFree(net);
+
+	net = newEmpty();
+	PoodleNetworkApplyChanges(net, NULL, 0);
+	CHECK(PoodleNetworkNumComputers(net) == 0);
+	PoodleNetworkFree(net);
+}
+
+// Checks the chosen source against a search from every computer
+static void checkChooseSource(PoodleNetwork net) {
+	int numComputers = PoodleNetworkNumComputers(net);
+	int want = -1;
+	int wantReached = 0;
+	for (int src = 0; src < numComputers; src++) {
+		int numReached = PoodleNetworkReachable(net, src, NULL);
+		if (numReached > wantReached) {
+			want = src;
+			wantReached = numReached;
+		}
+	}
+
+	struct chooseSourceResult res = PoodleNetworkChooseSource(net);
+	CHECK(res.sourceComputer == want);
+	CHECK(res.numComputers == wantReached);
+	if (res.sourceComputer == want && res.numComputers == wantReached && want != -1) {
+		int *reachable = malloc(wantReached * sizeof(int));
+		if (reachable == NULL) {
+			fprintf(stderr, "error: out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+		PoodleNetworkReachable(net, want, reachable);
+		for (int i = 0; i < wantReached; i++) {
+			CHECK(res.computers[i] == reachable[i]);
+		}
+		free(reachable);
+	}
+	free(res.computers);
+}
+
+// One handle's reachability workspace is reused by every search, with a
+// new epoch each time, so thousands of searches from different sources
+// (some listing what they reach and some only counting it) must not see
+// each other's marks
+static void testReachableRepeated(void) {
+	struct computer computers[NUM_GENERATED];
+	struct connection connections[NUM_GENERATED_CONNECTIONS];
+	generateNetwork(20, 10, computers, connections);
+	PoodleNetwork net = PoodleNetworkNew(
+		computers, NUM_GENERATED, connections, NUM_GENERATED_CONNECTIONS
+	);
+
+	// the plain searches are slow, so each source's is only run once
+	int *want = malloc(NUM_GENERATED * NUM_GENERATED * sizeof(int));
+	int numWanted[NUM_GENERATED];
+	int reachable[NUM_GENERATED];
+	if (want == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	for (int src = 0; src < NUM_GENERATED; src++) {
+		numWanted[src] = plainReachable(
+			computers, NUM_GENERATED, connections, NUM_GENERATED_CONNECTIONS,
+			src, &want[src * NUM_GENERATED]
+		);
+	}
+
+	for (int round = 0; round < 2000; round++) {
+		int src = (round * 7919) % NUM_GENERATED;
+		bool listed = round % 3 != 0;
+		int numReached = PoodleNetworkReachable(net, src, listed ? reachable : NULL);
+		CHECK(numReached == numWanted[src]);
+		for (int i = 0; listed && i < numReached && i < numWanted[src]; i++) {
+			CHECK(reachable[i] == want[src * NUM_GENERATED + i]);
+		}
+	}
+
+	free(want);
+	PoodleNetworkFree(net);
+}
+
+// Checks PoodleNetworkReachable from src against a plain search. If
+// listed, the computers are checked too, else only counted
+static void checkReachable(
+	PoodleNetwork net, struct computer computers[], int numComputers,
+	struct connection connections[], int numConnections, int src, bool listed
+) {
+	int *want = malloc(numComputers * sizeof(int));
+	int *reachable = malloc(numComputers * sizeof(int));
+	if (want == NULL || reachable == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	int numWanted = plainReachable(computers, numComputers, connections, numConnections, src, want);
+	int numReached = PoodleNetworkReachable(net, src, listed ? reachable : NULL);
+	CHECK(numReached == numWanted);
+	for (int i = 0; listed && i < numReached && i < numWanted; i++) {
+		CHECK(reachable[i] == want[i]);
+	}
+	free(want);
+	free(reachable);
+}
+
+// Searches switch to bottom-up once the frontier has a large share of the
+// unexplored arcs. A star's centre alone has half of them, and a dense
+// network's frontier soon does, so both make the switch, from the centre
+// at once and from a leaf after one level. Some of the star's leaves are
+// too secure for the centre to send to, but can send to it, so the
+// bottom-up levels have to respect the arcs' direction
+static void testReachableDense(void) {
+	int numComputers = 1000;
+	struct computer *computers = malloc(numComputers * sizeof(struct computer));
+	struct connection *connections = malloc(numComputers * numComputers / 8 * sizeof(struct connection));
+	if (computers == NULL || connections == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int v = 0; v < numComputers; v++) {
+		computers[v] = (struct computer){v % 5 == 0 ? 3 : 1, 1};
+	}
+	for (int v = 1; v < numComputers; v++) {
+		connections[v - 1] = (struct connection){0, v, 1};
+	}
+	PoodleNetwork net = PoodleNetworkNew(computers, numComputers, connections, numComputers - 1);
+	for (int src = 0; src < 12; src++) {
+		checkReachable(net, computers, numComputers, connections, numComputers - 1, src, true);
+	}
+	PoodleNetworkFree(net);
+
+	// every pair connected with probability 1/16, at four security levels
+	int numDense = 400;
+	int numConnections = 0;
+	srand(21);
+	for (int v = 0; v < numDense; v++) {
+		computers[v] = (struct computer){1 + rand() % 4, 1};
+		for (int w = v + 1; w < numDense; w++) {
+			if (rand() % 16 == 0) {
+				connections[numConnections++] = (struct connection){v, w, 1};
+			}
+		}
+	}
+	net = PoodleNetworkNew(computers, numDense, connections, numConnections);
+	for (int src = 0; src < numDense; src += 13) {
+		checkReachable(net, computers, numDense, connections, numConnections, src, src % 2 == 0);
+	}
+	PoodleNetworkFree(net);
+
+	free(computers);
+	free(connections);
+}
+
+// The chosen source comes from the source components: every computer in
+// one reaches the same computers, so the lowest numbered computer of the
+// components that reach the most is chosen
+static void testChooseSource(void) {
+	// 2, 3 and 4 send the pug to each other, and on to 0 and 5, which
+	// cannot send it back. 1 only reaches 0
+	struct computer cycle[] = {{1, 1}, {5, 1}, {5, 1}, {5, 1}, {5, 1}, {1, 1}};
+	struct connection cycleConnections[] = {
+		{3, 4, 1}, {4, 2, 1}, {2, 3, 1}, {3, 0, 1}, {4, 5, 1}, {1, 0, 1},
+	};
+	PoodleNetwork net = PoodleNetworkNew(cycle, 6, cycleConnections, 6);
+	struct chooseSourceResult res = PoodleNetworkChooseSource(net);
+	int reached[] = {0, 2, 3, 4, 5};
+	CHECK(res.sourceComputer == 2 && res.numComputers == 5);
+	for (int i = 0; i < 5 && i < res.numComputers; i++) {
+		CHECK(res.computers[i] == reached[i]);
+	}
+	free(res.computers);
+	checkChooseSource(net);
+	PoodleNetworkFree(net);
+
+	// 2 and 5 send the pug to each other and on to 0, and 4 to 1 and 3, so
+	// the two source components both reach three computers
+	struct computer tied[] = {{1, 1}, {1, 1}, {5, 1}, {1, 1}, {5, 1}, {5, 1}};
+	struct connection tiedConnections[] = {
+		{4, 3, 1}, {5, 0, 1}, {4, 1, 1}, {2, 5, 1}, {0, 2, 1},
+	};
+	net = PoodleNetworkNew(tied, 6, tiedConnections, 5);
+	res = PoodleNetworkChooseSource(net);
+	CHECK(res.sourceComputer == 2 && res.numComputers == 3);
+	free(res.computers);
+	checkChooseSource(net);
+	PoodleNetworkFree(net);
+
+	// with no connections every computer is its own source component
+	net = PoodleNetworkNew(tied, 6, NULL, 0);
+	res = PoodleNetworkChooseSource(net);
+	CHECK(res.sourceComputer == 0 && res.numComputers == 1);
+	free(res.computers);
+	PoodleNetworkFree(net);
+}
+
+// The task 2 index keeps the chosen source right through batches of
+// changes, small and large
+static void testChooseSourceChanges(void) {
+	PoodleNetwork net = newGenerated(16, 50);
+	checkChooseSource(net);
+	struct connection added[40 * 64];
+	int numAdded = 0;
+	for (int round = 0; round < 40; round++) {
+		struct networkChange batch[64];
+		int numChanges = (round % 5 == 4 ? 64 : 1 + round % 5);
+		randomChanges(batch, numChanges, 50, added, &numAdded);
+		PoodleNetworkApplyChanges(net, batch, numChanges);
+		checkChooseSource(net);
+	}
+	PoodleNetworkFree(net);
+
+	net = newUnreachable();
+	checkChooseSource(net);
+	struct networkChange cut = {CHANGE_REMOVE_CONNECTION, {1, 0, 0}, 0, {0, 0}};
+	PoodleNetworkApplyChanges(net, &cut, 1);
+	checkChooseSource(net);
+	PoodleNetworkFree(net);
+
+	net = newEmpty();
+	checkChooseSource(net);
+	PoodleNetworkApplyChanges(net, NULL, 0);
+	checkChooseSource(net);
+	PoodleNetworkFree(net);
+}
+
+// Orders link impacts as PoodleNetworkCriticalLinks lists them
+static int compareImpacts(const void *a, const void *b) {
+	const struct linkImpact *x = a;
+	const struct linkImpact *y = b;
+	if (x->reachedDelta != y->reachedDelta) {
+		return x->reachedDelta < y->reachedDelta ? -1 : 1;
+	}
+	if (x->makespanDelta != y->makespanDelta) {
+		return x->makespanDelta > y->makespanDelta ? -1 : 1;
+	}
+	if (x->connection.computerA != y->connection.computerA) {
+		return x->connection.computerA < y->connection.computerA ? -1 : 1;
+	}
+	return x->connection.computerB - y->connection.computerB;
+}
+
+// The time the last computer in a plan is poodled, or 0 if none is
+static int makespan(struct poodleResult res) {
+	return res.numSteps > 0 ? res.steps[res.numSteps - 1].time : 0;
+}
+
+// Checks the critical links from src against a plan without each
+// connection in turn. The connections must all join different pairs of
+// computers, each with computerA < computerB
+static void checkCriticalLinks(
+	struct computer computers[], int numComputers,
+	struct connection connections[], int numConnections, int src, int numThreads
+) {
+	PoodleNetwork net = PoodleNetworkNew(computers, numComputers, connections, numConnections);
+	PoodleNetworkSetThreads(net, numThreads);
+	struct poodleResult full = PoodleNetworkPoodle(net, src);
+
+	struct linkImpact *want = malloc((numConnections + 1) * sizeof(struct linkImpact));
+	struct connection *others = malloc((numConnections + 1) * sizeof(struct connection));
+	if (want == NULL || others == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	int numWanted = 0;
+	for (int i = 0; i < numConnections; i++) {
+		int numOthers = 0;
+		for (int j = 0; j < numConnections; j++) {
+			if (j != i) {
+				others[numOthers++] = connections[j];
+			}
+		}
+
+		PoodleNetwork without = PoodleNetworkNew(computers, numComputers, others, numOthers);
+		struct poodleResult res = PoodleNetworkPoodle(without, src);
+		if (makespan(res) != makespan(full) || res.numSteps != full.numSteps) {
+			want[numWanted++] = (struct linkImpact){
+				connections[i], makespan(res), makespan(res) - makespan(full),
+				res.numSteps - full.numSteps,
+			};
+		}
+		freeResult(res);
+		PoodleNetworkFree(without);
+	}
+	qsort(want, numWanted, sizeof(struct linkImpact), compareImpacts);
+
+	int numLinks = -1;
+	struct linkImpact *links = PoodleNetworkCriticalLinks(net, src, &numLinks);
+	CHECK(numLinks == numWanted);
+	for (int i = 0; i < numLinks && i < numWanted; i++) {
+		CHECK(links[i].connection.computerA == want[i].connection.computerA);
+		CHECK(links[i].connection.computerB == want[i].connection.computerB);
+		CHECK(links[i].connection.transmissionTime == want[i].connection.transmissionTime);
+		CHECK(links[i].makespan == want[i].makespan);
+		CHECK(links[i].makespanDelta == want[i].makespanDelta);
+		CHECK(links[i].reachedDelta == want[i].reachedDelta);
+	}
+
+	free(links);
+	free(others);
+	free(want);
+	freeResult(full);
+	PoodleNetworkFree(net);
+}
+
+// Critical links are exactly the connections whose loss changes the
+// plan's makespan or how many computers it poodles
+static void testCriticalLinks(void) {
+	for (int src = 0; src < 7; src++) {
+		checkCriticalLinks(sampleComputers, 7, sampleConnections, 12, src, 1);
+	}
+
+	// small networks with few security levels, so that losing a
+	// connection can cut computers off
+	int numComputers = 40;
+	struct computer computers[40];
+	struct connection connections[40 * 39 / 2];
+	srand(18);
+	for (int round = 0; round < 6; round++) {
+		for (int i = 0; i < numComputers; i++) {
+			computers[i].securityLevel = 1 + rand() % 3;
+			computers[i].poodleTime = rand() % 10;
+		}
+		int numConnections = 0;
+		for (int a = 0; a < numComputers; a++) {
+			for (int b = a + 1; b < numComputers; b++) {
+				if (rand() % numComputers < 3) {
+					connections[numConnections++] = (struct connection){a, b, rand() % 10};
+				}
+			}
+		}
+		for (int threads = 1; threads <= 4; threads += 3) {
+			checkCriticalLinks(computers, numComputers, connections, numConnections, round, threads);
+		}
+	}
+
+	checkCriticalLinks(unreachableComputers, 2, unreachableConnections, 1, 0, 1);
+	checkCriticalLinks(unreachableComputers, 2, unreachableConnections, 1, 1, 1);
+}
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+
+static void check(bool ok, char *cond, const char *func, int line) {
+	numChecked++;
+	if (!ok) {
+		numFailed++;
+		printf("%s, line %d: check failed: %s\n", func, line, cond);
+	}
+}
+
+// Checks v's row of neighbours through every way the graph gives it out
+static void checkNeighbours(Graph g, int v, int numNeighbours, int neighbours[], int times[]) {
+	CHECK(GraphNeighbourCount(g, v) == numNeighbours);
+	GraphNeighbourSpan span = GraphGetNeighbours(g, v);
+	CHECK(span.count == numNeighbours);
+	int *copy = GraphNeighbours(g, v);
+	for (int i = 0; i < numNeighbours && i < span.count; i++) {
+		CHECK(span.neighbours[i] == neighbours[i]);
+		CHECK(span.transmissionTimes[i] == times[i]);
+		CHECK(copy[i] == neighbours[i]);
+		CHECK(GraphIsAdjacent(g, v, neighbours[i]) && GraphIsAdjacent(g, neighbours[i], v));
+		CHECK(GraphGetTransmissionTime(g, v, neighbours[i]) == times[i]);
+	}
+	free(copy);
+}
+
+static PoodleNetwork newSample(void) {
+	return PoodleNetworkNew(sampleComputers, 7, sampleConnections, 12);
+}
+
+static PoodleNetwork newUnreachable(void) {
+	return PoodleNetworkNew(unreachableComputers, 2, unreachableConnections, 1);
+}
+
+static PoodleNetwork newEmpty(void) {
+	return PoodleNetworkNew(NULL, 0, NULL, 0);
+}
+
+static PoodleNetwork newGenerated(unsigned int seed, int maxTime) {
+	struct computer computers[NUM_GENERATED];
+	struct connection connections[NUM_GENERATED_CONNECTIONS];
+	generateNetwork(seed, maxTime, computers, connections);
+	return PoodleNetworkNew(
+		computers, NUM_GENERATED, connections, NUM_GENERATED_CONNECTIONS
+	);
+}
+
+// Fills in a network of NUM_GENERATED computers and
+// NUM_GENERATED_CONNECTIONS connections with times up to maxTime, the same
+// for the same seed
+static void generateNetwork(
+	unsigned int seed, int maxTime,
+	struct computer computers[], struct connection connections[]
+) {
+	srand(seed);
+	for (int i = 0; i < NUM_GENERATED; i++) {
+		computers[i].securityLevel = 1 + rand() % MAX_SECURITY_LEVEL;
+		computers[i].poodleTime = 1 + rand() % maxTime;
+	}
+	for (int i = 0; i < NUM_GENERATED_CONNECTIONS; i++) {
+		connections[i].computerA = rand() % NUM_GENERATED;
+		connections[i].computerB = rand() % NUM_GENERATED;
+		connections[i].transmissionTime = 1 + rand() % maxTime;
+	}
+}
+
+// Counts the computers src can send the pug to with a plain breadth-first
+// search over the connections, and writes them to reachable[] in
+// ascending order
+static int plainReachable(
+	struct computer computers[], int numComputers,
+	struct connection connections[], int numConnections,
+	int src, int reachable[]
+) {
+	// each computer's neighbours, as rows of one array
+	int *start = calloc(numComputers + 1, sizeof(int));
+	int *end = malloc(numComputers * sizeof(int));
+	int *neighbours = malloc((2 * numConnections + 1) * sizeof(int));
+	bool *seen = calloc(numComputers, sizeof(bool));
+	int *queue = malloc(numComputers * sizeof(int));
+	if (start == NULL || end == NULL || neighbours == NULL || seen == NULL || queue == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	for (int j = 0; j < numConnections; j++) {
+		start[connections[j].computerA + 1]++;
+		start[connections[j].computerB + 1]++;
+	}
+	for (int v = 0; v < numComputers; v++) {
+		start[v + 1] += start[v];
+		end[v] = start[v];
+	}
+	for (int j = 0; j < numConnections; j++) {
+		neighbours[end[connections[j].computerA]++] = connections[j].computerB;
+		neighbours[end[connections[j].computerB]++] = connections[j].computerA;
+	}
+
+	int head = 0;
+	int tail = 0;
+	queue[tail++] = src;
+	seen[src] = true;
+	while (head < tail) {
+		int v = queue[head++];
+		for (int i = start[v]; i < start[v + 1]; i++) {
+			int w = neighbours[i];
+			if (!seen[w] && computers[w].securityLevel <= computers[v].securityLevel + 1) {
+				seen[w] = true;
+				queue[tail++] = w;
+			}
+		}
+	}
+
+	int count = 0;
+	for (int v = 0; v < numComputers; v++) {
+		if (seen[v]) {
+			reachable[count++] = v;
+		}
+	}
+	free(start);
+	free(end);
+	free(neighbours);
+	free(seen);
+	free(queue);
+	return count;
+}
+
+// Checks whether two plans have the same steps, times and recipients
+static bool samePlan(struct poodleResult a, struct poodleResult b) {
+	if (a.numSteps != b.numSteps) {
+		return false;
+	}
+
+	for (int i = 0; i < a.numSteps; i++) {
+		if (!sameStep(a.steps[i], b.steps[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Checks whether two steps poodle the same computer at the same time and
+// send the pug to the same computers
+static bool sameStep(struct step a, struct step b) {
+	if (a.computer != b.computer || a.time != b.time) {
+		return false;
+	}
+
+	struct computerList *x = a.recipients;
+	struct computerList *y = b.recipients;
+	for (; x != NULL && y != NULL; x = x->next, y = y->next) {
+		if (x->computer != y->computer) {
+			return false;
+		}
+	}
+	return x == NULL && y == NULL;
+}
+
+static void freeResult(struct poodleResult res) {
+	for (int i = 0; i < res.numSteps; i++) {
+		struct computerList *curr = res.steps[i].recipients;
+		while (curr != NULL) {
+			struct computerList *temp = curr;
+			curr = curr->next;
+			free(temp);
+		}
+	}
+	free(res.steps);
+}
+
+// Returns when each computer is poodled from src, or INFINITY if it never
+// is, as given by PoodleNetworkPoodle. The array is freed with free
+static int *planTimes(PoodleNetwork net, int src) {
+	int numComputers = PoodleNetworkNumComputers(net);
+	int *times = malloc((numComputers > 0 ? numComputers : 1) * sizeof(int));
+	if (times == NULL) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	for (int v = 0; v < numComputers; v++) {
+		times[v] = INFINITY;
+	}
+
+	struct poodleResult res = PoodleNetworkPoodle(net, src);
+	for (int i = 0; i < res.numSteps; i++) {
+		times[res.steps[i].computer] = res.steps[i].time;
+	}
+	freeResult(res);
+	return times;
+}
+
+// Fills changes[] with random changes to a network from newGenerated. The
+// connections it adds are recorded in added[], and removals mostly take
+// one of them back out, so that they remove a connection that exists
+static void randomChanges(
+	struct networkChange changes[], int numChanges, int maxTime,
+	struct connection added[], int *numAdded
+) {
+	for (int i = 0; i < numChanges; i++) {
+		changes[i] = (struct networkChange){rand() % 3, {0, 0, 0}, 0, {0, 0}};
+		changes[i].connection.computerA = rand() % NUM_GENERATED;
+		changes[i].connection.computerB = rand() % NUM_GENERATED;
+		changes[i].connection.transmissionTime = 1 + rand() % maxTime;
+		changes[i].computer = rand() % NUM_GENERATED;
+		changes[i].info.securityLevel = 1 + rand() % MAX_SECURITY_LEVEL;
+		changes[i].info.poodleTime = 1 + rand() % maxTime;
+
+		if (changes[i].kind == CHANGE_ADD_CONNECTION) {
+			added[(*numAdded)++] = changes[i].connection;
+		} else if (changes[i].kind == CHANGE_REMOVE_CONNECTION && *numAdded > 0
+				&& rand() % 4 != 0) {
+			changes[i].connection = added[rand() % *numAdded];
+		}
+	}
+}